@@ -0,0 +1,162 @@
+///                                                                           
+/// Langulus::Logger                                                          
+/// Copyright (c) 2012 Dimo Markov <team@langulus.com>                        
+/// Part of the Langulus framework, see https://langulus.com                  
+///                                                                           
+/// SPDX-License-Identifier: MIT                                              
+///                                                                           
+/// Measures logger throughput for different workloads and sinks. Console     
+/// output goes to the null device, and results are written to stderr as      
+/// one JSON object per line:                                                 
+///    LangulusLoggerBench [lines] 2> results.jsonl                           
+/// The throughput is in payload bytes - the text the logger receives, which  
+/// is the same for all sinks, without the timestamps and markup they add     
+///                                                                           
+#include <Logger/Logger.hpp>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <functional>
+#include <string>
+
+using namespace Langulus;
+
+#ifdef _WIN32
+   #define LANGULUS_NULL_DEVICE "NUL"
+#else
+   #define LANGULUS_NULL_DEVICE "/dev/null"
+#endif
+
+
+/// Redirector, that only counts the bytes it receives                        
+struct Counter final : Logger::A::Interface {
+   mutable size_t mBytes = 0;
+
+   void Write(const Logger::TextView& text) const noexcept { mBytes += text.size(); }
+   void Write(Logger::Style) const noexcept {}
+   void NewLine() const noexcept { ++mBytes; }
+   void Clear() const noexcept {}
+};
+
+/// A logging statement, that is repeated for each measured line              
+struct Workload {
+   const char* mName;
+   std::function<void(int)> mCall;
+};
+
+/// A set of attachments, that receive the statements                         
+struct Sink {
+   const char* mName;
+   std::function<void()> mAttach;
+   std::function<void()> mDettach;
+};
+
+/// Run a workload for a number of lines                                      
+///   @param workload - the workload to run                                   
+///   @param lines - number of times to repeat the statement                  
+void Run(const Workload& workload, int lines) {
+   for (int i = 0; i < lines; ++i)
+      workload.mCall(i);
+   Logger::Flush();
+}
+
+/// Measure the number of payload bytes a workload produces, by running it   
+/// once through a counting redirector                                        
+///   @param workload - the workload to measure                               
+///   @param lines - number of times to repeat the statement                  
+///   @return the number of bytes                                             
+size_t MeasureBytes(const Workload& workload, int lines) {
+   Counter counter;
+   Logger::AttachRedirector(&counter);
+   Run(workload, lines);
+   Logger::DettachRedirector(&counter);
+   return counter.mBytes;
+}
+
+int main(int argc, char* argv[]) {
+   const int lines = argc > 1 ? std::atoi(argv[1]) : 20000;
+
+   // Console output is measured, but not shown                         
+   if (not std::freopen(LANGULUS_NULL_DEVICE, "w", stdout)) {
+      std::fprintf(stderr, "Can't redirect console to " LANGULUS_NULL_DEVICE "\n");
+      return 1;
+   }
+
+   const Workload workloads[] {
+      {"Line", [](int i) {
+         Logger::Line("Benchmark line #", i, " with some text and a number ", 3.14f);
+      }},
+      {"Append", [](int i) {
+         if (i % 16 == 0)
+            Logger::Line();
+         Logger::Append(" appended #", i);
+      }},
+      {"Section", [](int i) {
+         const auto scope = Logger::Section("Section #", i);
+         Logger::Line("Line inside section");
+      }},
+      {"Colors", [](int i) {
+         Logger::Info(Logger::Color::Red, "red ", Logger::Color::Green, "green ",
+            Logger::Color::Blue, "blue ", Logger::Emphasis::Underline, "underlined ",
+            Logger::Color::Yellow, i);
+      }},
+      {"Hex", [](int i) {
+         Logger::Line("Hex: ", Logger::Hex(i), ' ', Logger::Hex(static_cast<double>(i)));
+      }},
+      {"Format", [](int i) {
+         Logger::Line(Logger::Format("Formatted line #{} with a number {:.2f}", i, 3.14f));
+      }}
+   };
+
+   Logger::ToTXT txt {"LangulusLoggerBench.txt"};
+   Logger::ToHTML html {"LangulusLoggerBench.htm"};
+   Logger::ToMappedTXT mapped {"LangulusLoggerBenchMapped.txt"};
+
+   const Sink sinks[] {
+      {"Console", [] {}, [] {}},
+      {"TXT",
+         [&] { Logger::AttachRedirector(&txt); },
+         [&] { Logger::DettachRedirector(&txt); }},
+      {"MappedTXT",
+         [&] { Logger::AttachRedirector(&mapped); },
+         [&] { Logger::DettachRedirector(&mapped); }},
+      {"HTML",
+         [&] { Logger::AttachRedirector(&html); },
+         [&] { Logger::DettachRedirector(&html); }},
+      {"MessageSink",
+         [] { Logger::AttachRedirector(&Logger::MessageSinkInstance); },
+         [] { Logger::DettachRedirector(&Logger::MessageSinkInstance); }},
+      {"Console+TXT+HTML",
+         [&] { Logger::AttachDuplicator(&txt); Logger::AttachDuplicator(&html); },
+         [&] { Logger::DettachDuplicator(&txt); Logger::DettachDuplicator(&html); }},
+      {"TXT+MessageSink",
+         [&] { Logger::AttachRedirector(&txt); Logger::AttachRedirector(&Logger::MessageSinkInstance); },
+         [&] { Logger::DettachRedirector(&txt); Logger::DettachRedirector(&Logger::MessageSinkInstance); }}
+   };
+
+   for (const bool async : {false, true}) {
+      Logger::SetAsync(async);
+
+      for (auto& workload : workloads) {
+         const auto payload = MeasureBytes(workload, lines);
+
+         for (auto& sink : sinks) {
+            sink.mAttach();
+            const auto start = std::chrono::steady_clock::now();
+            Run(workload, lines);
+            const auto end = std::chrono::steady_clock::now();
+            sink.mDettach();
+
+            const auto ns = std::chrono::duration<double, std::nano>(end - start).count();
+            std::fprintf(stderr,
+               "{\"workload\": \"%s\", \"sink\": \"%s\", \"async\": %s, "
+               "\"lines\": %d, \"ns_per_line\": %.1f, \"payload_bytes_per_sec\": %.0f}\n",
+               workload.mName, sink.mName, async ? "true" : "false",
+               lines, ns / lines, payload / (ns * 1e-9));
+         }
+      }
+   }
+
+   Logger::SetAsync(false);
+   return 0;
+}
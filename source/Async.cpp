@@ -0,0 +1,549 @@
+///                                                                           
+/// Langulus::Logger                                                          
+/// Copyright (c) 2012 Dimo Markov <team@langulus.com>                        
+/// Part of the Langulus framework, see https://langulus.com                  
+///                                                                           
+/// SPDX-License-Identifier: MIT                                              
+///                                                                           
+#include "Async.hpp"
+#include <vector>
+#include <mutex>
+#include <bit>
+
+using namespace Langulus;
+using namespace Langulus::Logger;
+using namespace Langulus::Logger::Inner;
+
+
+/// Records, that are produced by the current thread during a ScopedBatch,    
+/// and will be pushed to the queue as a single contiguous group              
+struct Staging {
+   ::std::vector<Record> mRecords;
+   int mDepth = 0;
+};
+
+thread_local Staging tStaging;
+
+/// The worker, whose thread is the current one                               
+thread_local const Worker* tWorker = nullptr;
+
+/// Consecutive repeats of a statement, that are held back, shared by all     
+/// threads, because repeats from different threads are still repeats         
+struct Inner::Repeats {
+   ::std::mutex mMutex;
+   // Hash of the last statement that was let through                   
+   uint64_t mHash = 0;
+   bool mValid = false;
+   // Number of repeats held back since the statement, or the last summary
+   size_t mCount = 0;
+   // When the statement was logged, and when it last repeated          
+   TimePoint mFirst;
+   TimePoint mLast;
+   // Intent and tabs for the summary                                   
+   Intent mIntent = Intent::Info;
+   uint32_t mTabs = 0;
+};
+
+/// Get the held back repeats. The logger's constructor creates them, so      
+/// that they are destroyed after the logger, which writes them               
+///   @return the held back repeats                                           
+Repeats& Inner::GetRepeats() noexcept {
+   static Repeats repeats;
+   return repeats;
+}
+
+/// Writes the repeats, that are held back, when the thread that repeated     
+/// them ends, while the rest of its state is still alive. The main thread    
+/// ends when the process exits, before the logger is destroyed               
+struct Inner::RepeatsGuard {
+   ~RepeatsGuard() {
+      Instance.ReleaseRepeats();
+   }
+};
+
+/// Create the ring buffer                                                    
+///   @param capacity - number of slots, rounded up to a power of two         
+Queue::Queue(size_t capacity)
+   : mSlots {new Slot[::std::bit_ceil(::std::max<size_t>(capacity, 2))]}
+   , mMask  {::std::bit_ceil(::std::max<size_t>(capacity, 2)) - 1} {
+   for (size_t i = 0; i <= mMask; ++i)
+      mSlots[i].mSequence.store(i, ::std::memory_order_relaxed);
+}
+
+/// Reserve a contiguous range of slots, and publish records into them        
+///   @param records - the records to push                                    
+///   @param count - number of records, must not exceed the capacity          
+///   @return true if records were pushed, false if queue is full             
+bool Queue::Push(const Record* records, size_t count) noexcept {
+   auto pos = mTail.load(::std::memory_order_relaxed);
+   while (true) {
+      // The consumer frees slots in order, so if the last slot of the  
+      // range is free, then all the slots before it are free, too      
+      const auto last = pos + count - 1;
+      const auto sequence = mSlots[last & mMask].mSequence
+         .load(::std::memory_order_acquire);
+      const auto difference = static_cast<intptr_t>(sequence)
+                            - static_cast<intptr_t>(last);
+
+      if (difference == 0) {
+         if (mTail.compare_exchange_weak(pos, pos + count,
+             ::std::memory_order_relaxed))
+            break;
+      }
+      else if (difference < 0)
+         return false;
+      else
+         pos = mTail.load(::std::memory_order_relaxed);
+   }
+
+   for (size_t i = 0; i < count; ++i) {
+      auto& slot = mSlots[(pos + i) & mMask];
+      ::std::memcpy(&slot.mRecord, records + i, records[i].GetUsedBytes());
+      slot.mSequence.store(pos + i + 1, ::std::memory_order_release);
+   }
+   return true;
+}
+
+/// Create a worker                                                           
+///   @param capacity - the number of records the queue can hold              
+///   @param dispatcher - function to call for each consumed record           
+///   @param idler - function to call when worker runs out of records, and    
+///      one last time, with stopping set, before its thread ends             
+Worker::Worker(size_t capacity, Dispatcher&& dispatcher, Idler&& idler)
+   : mQueue    {capacity}
+   , mDispatch {::std::move(dispatcher)}
+   , mIdle     {::std::move(idler)} {}
+
+/// Stop the worker's thread                                                  
+Worker::~Worker() {
+   Stop();
+}
+
+/// Start the thread                                                          
+void Worker::Start() {
+   if (mThread.joinable())
+      return;
+
+   mRunning.store(true);
+   mThread = ::std::thread {&Worker::Run, this};
+}
+
+/// Stop the thread, dispatching any remaining records on the caller's        
+/// thread. The queue stays valid, so producers that raced with stopping      
+/// don't lose anything - their records are dispatched on the next start,     
+/// or on the next stop                                                       
+void Worker::Stop() noexcept {
+   if (mThread.joinable()) {
+      mRunning.store(false);
+      {
+         ::std::scoped_lock lock {mMutex};
+         mWake.notify_one();
+      }
+      mThread.join();
+   }
+
+   Drain();
+}
+
+/// Push a group of records, blocking while the queue is full                 
+///   @param records - the records to push                                    
+///   @param count - the number of records to push                            
+void Worker::Push(const Record* records, size_t count) noexcept {
+   const auto capacity = mQueue.GetCapacity();
+   while (count) {
+      const auto group = ::std::min(count, capacity);
+      while (not mQueue.Push(records, group)) {
+         if (IsWorkerThread()) {
+            // The queue is full, and a sink is logging from inside the 
+            // worker - waiting would deadlock, so dispatch directly    
+            for (size_t i = 0; i < group; ++i)
+               mDispatch(records[i]);
+            break;
+         }
+
+         ::std::this_thread::yield();
+      }
+
+      records += group;
+      count -= group;
+   }
+
+   Wake();
+}
+
+/// Push a group of records, unless the queue doesn't have room for all of    
+/// them right now                                                            
+///   @param records - the records to push                                    
+///   @param count - the number of records, must not exceed the capacity      
+///   @return true if records were pushed, false if they were not             
+bool Worker::TryPush(const Record* records, size_t count) noexcept {
+   if (not mQueue.Push(records, count))
+      return false;
+
+   Wake();
+   return true;
+}
+
+/// Wake the worker up if it is sleeping                                      
+void Worker::Wake() noexcept {
+   ::std::atomic_thread_fence(::std::memory_order_seq_cst);
+   if (mSleeping.load(::std::memory_order_relaxed)) {
+      ::std::scoped_lock lock {mMutex};
+      mWake.notify_one();
+   }
+}
+
+/// Block until all records, pushed before this call, are dispatched          
+void Worker::Flush() noexcept {
+   if (IsWorkerThread()) {
+      Drain();
+      return;
+   }
+
+   const auto target = mQueue.GetTail();
+   auto done = mDone.load(::std::memory_order_acquire);
+   while (done < target) {
+      {
+         ::std::scoped_lock lock {mMutex};
+         mWake.notify_one();
+      }
+      mDone.wait(done, ::std::memory_order_acquire);
+      done = mDone.load(::std::memory_order_acquire);
+   }
+}
+
+/// Check if the caller is the worker thread                                  
+bool Worker::IsWorkerThread() const noexcept {
+   return tWorker == this;
+}
+
+/// Dispatch all available records                                            
+///   @return the number of dispatched records                                
+size_t Worker::Drain() noexcept {
+   size_t count = 0;
+   while (mQueue.Pop(mDispatch))
+      ++count;
+
+   if (count) {
+      mDone.store(mQueue.GetHead(), ::std::memory_order_release);
+      mDone.notify_all();
+   }
+   return count;
+}
+
+/// The worker thread's loop                                                  
+void Worker::Run() noexcept {
+   tWorker = this;
+   while (mRunning.load(::std::memory_order_relaxed)) {
+      if (Drain())
+         continue;
+
+      // Ran out of records, so this is a good time to write buffers    
+      if (mIdle)
+         mIdle(false);
+
+      // Nothing to do, so go to sleep, unless something arrived while  
+      // we were announcing it                                          
+      ::std::unique_lock lock {mMutex};
+      mSleeping.store(true, ::std::memory_order_relaxed);
+      ::std::atomic_thread_fence(::std::memory_order_seq_cst);
+      if (mQueue.GetHead() == mQueue.GetTail() and mRunning.load())
+         mWake.wait_for(lock, ::std::chrono::milliseconds {100});
+      mSleeping.store(false, ::std::memory_order_relaxed);
+   }
+
+   // Write out the rest from this thread, while its state is alive     
+   Drain();
+   if (mIdle)
+      mIdle(true);
+}
+
+
+/// Hash the contents of a statement - its intents, tabs and text, but not    
+/// its time and styles                                                       
+///   @param records - the records of the statement                           
+///   @return the hash                                                        
+uint64_t HashStatement(const ::std::vector<Record>& records) noexcept {
+   // FNV-1a                                                            
+   uint64_t hash = 14695981039346656037ull;
+   const auto mix = [&hash](const void* data, size_t size) {
+      auto bytes = static_cast<const uint8_t*>(data);
+      for (size_t i = 0; i < size; ++i)
+         hash = (hash ^ bytes[i]) * 1099511628211ull;
+   };
+
+   for (auto& record : records) {
+      if (record.type == Record::Stylize)
+         continue;
+
+      mix(&record.type, sizeof(record.type));
+      mix(&record.intent, sizeof(record.intent));
+      mix(&record.tabs, sizeof(record.tabs));
+      mix(record.text, record.size);
+      if (record.type == Record::Deferred)
+         mix(&record.formatter, sizeof(record.formatter));
+   }
+   return hash;
+}
+
+/// Make a line, that tells how many times a statement was repeated           
+///   @param repeats - the held back repeats, the count is reset              
+///   @param style - the style of the line                                    
+///   @param into - where to append the line's records                        
+void Summarize(Repeats& repeats, Style style, ::std::vector<Record>& into) {
+   Record records[2];
+   auto& line = records[0];
+   line.type = Record::NewLine;
+   line.intent = repeats.mIntent;
+   line.tabs = repeats.mTabs;
+   line.time = repeats.mLast;
+   line.style = style;
+   line.size = 0;
+
+   const auto seconds = ::std::chrono::duration<double> {
+      repeats.mLast - repeats.mFirst}.count();
+   auto& text = records[1];
+   text.type = Record::Text;
+   text.intent = repeats.mIntent;
+   text.tabs = repeats.mTabs;
+   const auto result = ::fmt::format_to_n(text.text, Record::Capacity,
+      "(the line above repeated {} more times in {:.3f} s)",
+      repeats.mCount, seconds);
+   text.size = static_cast<uint16_t>(
+      ::std::min<size_t>(result.size, Record::Capacity));
+
+   into.insert(into.begin(), records, records + 2);
+   repeats.mCount = 0;
+}
+
+/// Take a summary of the held back repeats, if there are any                 
+///   @param logger - the logger, for intent styles and the timeout           
+///   @param timedOut - take it only if the repeats went on for RepeatTimeout 
+///   @return the summary's records, or nothing                               
+::std::vector<Record> Inner::TakeRepeats(const Interface& logger, bool timedOut) noexcept {
+   ::std::vector<Record> summary;
+   try {
+      auto& repeats = GetRepeats();
+      ::std::scoped_lock lock {repeats.mMutex};
+      if (repeats.mCount == 0 or (timedOut
+      and TimePoint::clock::now() - repeats.mFirst < logger.RepeatTimeout))
+         return summary;
+
+      const auto intent = repeats.mIntent;
+      Summarize(repeats, intent < Intent::Counter
+         ? logger.IntentStyle[int(intent)].style : Style {}, summary);
+      repeats.mFirst = repeats.mLast;
+   }
+   catch (...) { summary.clear(); }
+   return summary;
+}
+
+/// Hold back a statement, if it repeats the previous one                     
+///   @param logger - the logger, for intent styles and the timeout           
+///   @param staged - the statement's records, a summary of the previous      
+///      repeats might be put in front of them, or replace them               
+///   @return true if there's nothing to log                                  
+bool SuppressRepeat(const Interface& logger, ::std::vector<Record>& staged) {
+   const auto hash = HashStatement(staged);
+   auto time = TimePoint::clock::now();
+   for (auto& record : staged) {
+      if (record.type == Record::NewLine) {
+         time = record.time;
+         break;
+      }
+   }
+
+   const auto styleOf = [&logger](Intent i) {
+      return i < Intent::Counter ? logger.IntentStyle[int(i)].style : Style {};
+   };
+
+   auto& repeats = GetRepeats();
+   ::std::scoped_lock lock {repeats.mMutex};
+   if (repeats.mValid and repeats.mHash == hash) {
+      ++repeats.mCount;
+      repeats.mLast = time;
+      if (time - repeats.mFirst < logger.RepeatTimeout)
+         return true;
+
+      // Repeating for too long, so write what we have, and count anew  
+      staged.clear();
+      Summarize(repeats, styleOf(repeats.mIntent), staged);
+      repeats.mFirst = time;
+      return false;
+   }
+
+   // A different statement ends the repeats                            
+   if (repeats.mCount)
+      Summarize(repeats, styleOf(repeats.mIntent), staged);
+
+   repeats.mHash = hash;
+   repeats.mValid = true;
+   repeats.mFirst = repeats.mLast = time;
+   repeats.mIntent = staged.back().intent;
+   repeats.mTabs = staged.back().tabs;
+   return false;
+}
+
+
+/// Enable or disable asynchronous logging                                    
+/// In asynchronous mode, logging calls only encode records into a lock-free  
+/// queue, and a background thread writes them to the console and to all      
+/// attachments                                                               
+///   @attention AsyncQueueSize is used only the first time async mode is     
+///      enabled                                                              
+///   @param enable - whether to enable asynchronous mode                     
+void Interface::SetAsync(bool enable) noexcept {
+   if (enable == IsAsync())
+      return;
+
+   if (enable) {
+      try {
+         if (not mWorker) {
+            mWorker = ::std::make_unique<Worker>(AsyncQueueSize,
+               [this](const Record& record) { Dispatch(record); },
+               [this](bool stopping) {
+                  // Repeats might go on for too long, with nothing else
+                  // logged to write them                               
+                  if (SuppressRepeats.load(::std::memory_order_relaxed)) {
+                     auto summary = TakeRepeats(*this, true);
+                     if (not summary.empty()) {
+                        summary.back().ends = true;
+                        for (auto& record : summary)
+                           Dispatch(record);
+                     }
+                  }
+
+                  // Lines are assembled on the worker thread, so it    
+                  // delivers the unfinished ones, too, before it ends  
+                  ConsoleCommit(true);
+                  DeliverRecords(not stopping);
+               });
+         }
+
+         mWorker->Start();
+         mAsync.store(mWorker.get(), ::std::memory_order_release);
+      }
+      catch (...) { Logger::Append("<logger error>"); }
+   }
+   else {
+      // The worker is never destroyed before the logger, so anything   
+      // pushed by racing producers won't be lost. The worker delivers  
+      // everything before it stops, so this thread's state, that might 
+      // already be gone while the logger is destroyed, isn't touched   
+      mAsync.store(nullptr, ::std::memory_order_release);
+      mWorker->Stop();
+   }
+}
+
+/// Check if logger is in asynchronous mode                                   
+///   @return true if a background thread does the writing                    
+bool Interface::IsAsync() const noexcept {
+   return mAsync.load(::std::memory_order_acquire) != nullptr;
+}
+
+/// Write a summary of the repeats, that are held back, if there are any      
+void Interface::ReleaseRepeats() const noexcept {
+   if (not SuppressRepeats.load(::std::memory_order_relaxed))
+      return;
+
+   auto summary = TakeRepeats(*this, false);
+   Release(summary.data(), summary.size());
+}
+
+/// Block until everything logged so far has been written                     
+void Interface::Flush() const noexcept {
+   // Throttled call sites might not log again, so report their skips   
+   Throttle::ReportSkipped();
+   FlushQueued();
+}
+
+/// Block until everything logged so far has been written, without adding     
+/// anything of its own, except for the repeats that are held back            
+void Interface::FlushQueued() const noexcept {
+   // Repeats, that are held back, aren't written until something else is
+   // logged, so write them now                                         
+   ReleaseRepeats();
+
+   if (auto worker = mAsync.load(::std::memory_order_acquire)) {
+      // Make the worker write whatever it has buffered, too            
+      Record record;
+      record.type = Record::Flush;
+      record.ends = true;
+      record.intent = GetIntent();
+      record.tabs = static_cast<uint32_t>(GetTabs());
+      record.size = 0;
+      worker->Push(&record, 1);
+      worker->Flush();
+      ConsoleFlushNow();
+   }
+   else {
+      const ::std::scoped_lock lock {mStatements};
+      DispatchFlush();
+   }
+
+   fflush(stdout);
+   fflush(stderr);
+}
+
+/// Encode a logger call, and release it right away, unless a batch is in     
+/// progress - then the record is staged until it ends                        
+///   @param record - the record to push                                      
+void Interface::Enqueue(const Record& record) const noexcept {
+   auto whole = record;
+   if (tStaging.mDepth == 0) {
+      Release(&whole, 1);
+      return;
+   }
+
+   try { tStaging.mRecords.push_back(record); }
+   catch (...) { Release(&whole, 1); }
+}
+
+/// Begin a batch - everything logged by the current thread will be released  
+/// at once, when the outermost batch ends. Arguments are formatted while     
+/// staging, so threads format in parallel, and take turns only to dispatch   
+ScopedBatch::ScopedBatch() noexcept {
+   ++tStaging.mDepth;
+}
+
+/// End a batch                                                               
+ScopedBatch::~ScopedBatch() noexcept {
+   if (--tStaging.mDepth == 0) {
+      Instance.Commit();
+      Instance.CheckFlightRecorder();
+   }
+}
+
+/// Release all records, staged by the current thread, to the worker, or      
+/// dispatch them, if there is no worker                                      
+void Interface::Commit() const noexcept {
+   auto& staged = tStaging.mRecords;
+   if (staged.empty())
+      return;
+
+   if (SuppressRepeats.load(::std::memory_order_relaxed)) {
+      bool suppressed;
+      try { suppressed = SuppressRepeat(*this, staged); }
+      catch (...) { suppressed = false; }
+
+      if (suppressed) {
+         // Created after the rest of the thread's state, which the     
+         // statement has used, so it is destroyed before it            
+         static thread_local RepeatsGuard guard;
+         staged.clear();
+         return;
+      }
+   }
+
+   // Attachments might log while the statement is dispatched, staging  
+   // their own statements, so take the records out of the way          
+   auto statement = ::std::move(staged);
+   staged.clear();
+   Release(statement.data(), statement.size());
+
+   // Keep the memory for the next statement                            
+   if (staged.empty()) {
+      statement.clear();
+      staged = ::std::move(statement);
+   }
+}
@@ -0,0 +1,218 @@
+///                                                                           
+/// Langulus::Logger                                                          
+/// Copyright (c) 2012 Dimo Markov <team@langulus.com>                        
+/// Part of the Langulus framework, see https://langulus.com                  
+///                                                                           
+/// SPDX-License-Identifier: MIT                                              
+///                                                                           
+#pragma once
+#include "Logger.hpp"
+#include <atomic>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <functional>
+#include <memory>
+#include <vector>
+
+
+namespace Langulus::Logger::Inner
+{
+
+   ///                                                                        
+   /// A single encoded logger call, as it travels through the async queue    
+   ///                                                                        
+   struct Record {
+      enum Type : uint8_t {
+         Text,       // Write a piece of text
+         Stylize,    // Change the style
+         NewLine,    // Start a new line, using intent, tabs and style
+         Clear,      // Clear the log
+         Flush,      // Write anything that is buffered
+         Deferred    // Format the bytes of a value, and write the result
+      };
+
+      // Text that doesn't fit is split into several consecutive records
+      static constexpr size_t Capacity = 192;
+
+      Type      type;
+      // Set on the last record of a statement, because producers publish
+      // the records of a statement one by one, and the worker might run
+      // out of them in the middle                                      
+      bool      ends = false;
+      Intent    intent;
+      uint16_t  size;
+      uint32_t  tabs;
+      TimePoint time;
+      Style     style;
+      Formatter formatter;
+      Letter    text[Capacity];
+
+      /// Number of bytes that are actually used by the record                
+      size_t GetUsedBytes() const noexcept {
+         return offsetof(Record, text) + size;
+      }
+   };
+
+   static_assert(Record::Capacity >= MaxDeferredSize,
+      "Deferred values must fit in a single record");
+
+   struct Repeats;
+
+   void UseContext(const Record&) noexcept;
+   Repeats& GetRepeats() noexcept;
+   ::std::vector<Record> TakeRepeats(const Interface&, bool timedOut) noexcept;
+
+   ///                                                                        
+   /// Keeps the current thread's context while records are dispatched on     
+   /// it, restoring the context when destroyed                               
+   ///                                                                        
+   struct SavedContext {
+      Intent    mIntent;
+      size_t    mTabs;
+      TimePoint mTime;
+      Style     mStyle;
+      bool      mStyled;
+
+      SavedContext() noexcept;
+      ~SavedContext() noexcept;
+   };
+
+
+   ///                                                                        
+   /// Bounded lock-free multi-producer single-consumer ring of records       
+   /// Producers reserve a contiguous range of slots with a single CAS, so    
+   /// a group of records (i.e. a whole logging statement) is never           
+   /// interleaved with records from other threads                            
+   ///                                                                        
+   class Queue {
+      struct alignas(64) Slot {
+         ::std::atomic<size_t> mSequence;
+         Record mRecord;
+      };
+
+      ::std::unique_ptr<Slot[]> mSlots;
+      const size_t mMask;
+
+      // Producers contend for the tail, the consumer owns the head     
+      alignas(64) ::std::atomic<size_t> mTail {0};
+      alignas(64) ::std::atomic<size_t> mHead {0};
+
+   public:
+      explicit Queue(size_t capacity);
+
+      bool Push(const Record*, size_t count) noexcept;
+
+      /// Consume a single record, if one has been published                  
+      ///   @param call - function to invoke with the record                  
+      ///   @return true if a record was consumed                             
+      template<class F>
+      bool Pop(F&& call) noexcept {
+         const auto head = mHead.load(::std::memory_order_relaxed);
+         auto& slot = mSlots[head & mMask];
+         if (slot.mSequence.load(::std::memory_order_acquire) != head + 1)
+            return false;
+
+         call(const_cast<const Record&>(slot.mRecord));
+         slot.mSequence.store(head + mMask + 1, ::std::memory_order_release);
+         mHead.store(head + 1, ::std::memory_order_release);
+         return true;
+      }
+
+      /// Look at the published records, without consuming them. Records may  
+      /// be consumed while looking, so this is only for emergencies          
+      ///   @param call - function to invoke with each record                 
+      template<class F>
+      void Peek(F&& call) const noexcept {
+         const auto tail = mTail.load(::std::memory_order_acquire);
+         for (auto index = mHead.load(::std::memory_order_acquire); index < tail; ++index) {
+            auto& slot = mSlots[index & mMask];
+            if (slot.mSequence.load(::std::memory_order_acquire) != index + 1)
+               break;
+            call(const_cast<const Record&>(slot.mRecord));
+         }
+      }
+
+      /// Get the number of slots                                             
+      size_t GetCapacity() const noexcept {
+         return mMask + 1;
+      }
+
+      /// Get the number of slots ever reserved by producers                  
+      size_t GetTail() const noexcept {
+         return mTail.load(::std::memory_order_acquire);
+      }
+
+      /// Get the number of slots ever consumed                               
+      size_t GetHead() const noexcept {
+         return mHead.load(::std::memory_order_acquire);
+      }
+   };
+
+
+   ///                                                                        
+   /// A background thread, that drains a queue of records                    
+   ///                                                                        
+   class Worker {
+   public:
+      using Dispatcher = ::std::function<void(const Record&)>;
+      using Idler = ::std::function<void(bool stopping)>;
+
+   private:
+      Queue mQueue;
+      Dispatcher mDispatch;
+      Idler mIdle;
+      ::std::atomic<bool> mRunning {false};
+
+      // Sleeping/waking is the only place where a lock is involved     
+      ::std::mutex mMutex;
+      ::std::condition_variable mWake;
+      ::std::atomic<bool> mSleeping {false};
+
+      // Number of consumed records, used to wait on Flush()            
+      ::std::atomic<size_t> mDone {0};
+
+      ::std::thread mThread;
+
+      void Run() noexcept;
+      size_t Drain() noexcept;
+      void Wake() noexcept;
+
+   public:
+      Worker(size_t capacity, Dispatcher&&, Idler&& = {});
+      ~Worker();
+
+      void Start();
+      void Stop() noexcept;
+
+      void Push(const Record*, size_t count) noexcept;
+      bool TryPush(const Record*, size_t count) noexcept;
+      void Flush() noexcept;
+      bool IsWorkerThread() const noexcept;
+
+      /// Look at the records, that are waiting to be dispatched              
+      ///   @param call - function to invoke with each record                 
+      template<class F>
+      void Peek(F&& call) const noexcept {
+         mQueue.Peek(::std::forward<F>(call));
+      }
+
+      /// Get the number of records the queue can hold                        
+      size_t GetCapacity() const noexcept {
+         return mQueue.GetCapacity();
+      }
+
+      /// Get the number of records, that are waiting to be dispatched        
+      size_t GetPending() const noexcept {
+         const auto head = mQueue.GetHead();
+         const auto tail = mQueue.GetTail();
+         return tail > head ? tail - head : 0;
+      }
+
+      /// Get the number of records, that were dispatched so far              
+      size_t GetDispatched() const noexcept {
+         return mQueue.GetHead();
+      }
+   };
+
+} // namespace Langulus::Logger::Inner
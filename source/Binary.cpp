@@ -0,0 +1,446 @@
+///                                                                           
+/// Langulus::Logger                                                          
+/// Copyright (c) 2012 Dimo Markov <team@langulus.com>                        
+/// Part of the Langulus framework, see https://langulus.com                  
+///                                                                           
+/// SPDX-License-Identifier: MIT                                              
+///                                                                           
+#include "Binary.hpp"
+#include "Async.hpp"
+#include <fstream>
+#include <cstring>
+#include <limits>
+
+using namespace Langulus;
+using namespace Langulus::Logger;
+using namespace Langulus::Logger::Inner;
+
+/// Text of the same style is merged into records of at most this size        
+constexpr size_t MaxTextRecord = 64 * 1024;
+
+/// Style ids are reused after this many different styles                     
+constexpr size_t MaxStyles = 4096;
+
+/// Table for the reflected CRC-32 polynomial                                 
+constexpr auto CrcTable = [] {
+   ::std::array<uint32_t, 256> table {};
+   for (uint32_t i = 0; i < 256; ++i) {
+      uint32_t crc = i;
+      for (int bit = 0; bit < 8; ++bit)
+         crc = (crc >> 1) ^ (crc & 1 ? 0xEDB88320u : 0u);
+      table[i] = crc;
+   }
+   return table;
+}();
+
+
+/// Calculate the CRC-32 of a block of memory                                 
+///   @param data - the memory                                                
+///   @param size - number of bytes                                           
+///   @param previous - checksum of the preceding memory, for chaining        
+///   @return the checksum                                                    
+uint32_t Inner::Checksum(const void* data, size_t size, uint32_t previous) noexcept {
+   auto bytes = static_cast<const uint8_t*>(data);
+   uint32_t crc = ~previous;
+   while (size--)
+      crc = CrcTable[(crc ^ *bytes++) & 0xFF] ^ (crc >> 8);
+   return ~crc;
+}
+
+/// Append a LEB128 varint to a header                                        
+///   @param to - where to write                                              
+///   @param value - the value to write                                       
+///   @return the number of written bytes                                     
+size_t PutVarint(uint8_t* to, uint64_t value) noexcept {
+   size_t size = 0;
+   while (value >= 0x80) {
+      to[size++] = static_cast<uint8_t>(value | 0x80);
+      value >>= 7;
+   }
+   to[size++] = static_cast<uint8_t>(value);
+   return size;
+}
+
+/// Encode a signed number, so that small magnitudes make small varints       
+constexpr uint64_t ZigZag(int64_t value) noexcept {
+   return (static_cast<uint64_t>(value) << 1) ^ static_cast<uint64_t>(value >> 63);
+}
+
+constexpr int64_t UnZigZag(uint64_t value) noexcept {
+   return static_cast<int64_t>(value >> 1) ^ -static_cast<int64_t>(value & 1);
+}
+
+/// Pack a style                                                              
+///   @param style - the style to pack                                        
+PackedStyle::PackedStyle(const Style& style) noexcept {
+   if (style.has_emphasis())
+      mEmphasis = static_cast<uint8_t>(style.get_emphasis());
+
+   if (style.has_foreground()) {
+      const auto color = style.get_foreground();
+      mFlags |= HasForeground;
+      if (color.is_rgb) {
+         mFlags |= ForegroundRGB;
+         mForeground = color.value.rgb_color;
+      }
+      else mForeground = color.value.term_color;
+   }
+
+   if (style.has_background()) {
+      const auto color = style.get_background();
+      mFlags |= HasBackground;
+      if (color.is_rgb) {
+         mFlags |= BackgroundRGB;
+         mBackground = color.value.rgb_color;
+      }
+      else mBackground = color.value.term_color;
+   }
+}
+
+/// Unpack a style                                                            
+///   @return the style                                                       
+Style PackedStyle::Unpack() const noexcept {
+   Style style {static_cast<fmt::emphasis>(mEmphasis)};
+
+   if (mFlags & HasForeground) {
+      if (mFlags & ForegroundRGB)
+         style |= fmt::fg(fmt::rgb {mForeground});
+      else
+         style |= fmt::fg(static_cast<fmt::terminal_color>(mForeground));
+   }
+
+   if (mFlags & HasBackground) {
+      if (mFlags & BackgroundRGB)
+         style |= fmt::bg(fmt::rgb {mBackground});
+      else
+         style |= fmt::bg(static_cast<fmt::terminal_color>(mBackground));
+   }
+   return style;
+}
+
+
+/// Create the file, and write the header                                     
+///   @param filename - the relative filename of the log file                 
+///   @param policy - buffering, flushing, syncing and rotation policy        
+BinaryWriter::BinaryWriter(const TextView& filename, const FilePolicy& policy)
+   : mFile {filename, policy} {
+   WriteHeader();
+}
+
+/// Write the text that is still pending                                      
+BinaryWriter::~BinaryWriter() {
+   Flush();
+}
+
+/// Write the file header, and forget all styles and times, because each      
+/// file must be decodable on its own                                         
+void BinaryWriter::WriteHeader() noexcept {
+   mFile.Write({BinaryMagic.data(), BinaryMagic.size()});
+   mStyles.clear();
+   mStyle = 0;
+   mLastTime = 0;
+}
+
+/// Write a single record, followed by its checksum                           
+///   @param header - the header of the record                                
+///   @param headerSize - number of bytes in the header                       
+///   @param payload - the data after the header                              
+///   @param size - number of bytes in the payload                            
+void BinaryWriter::WriteRecord(const uint8_t* header, size_t headerSize, const void* payload, size_t size) noexcept {
+   const auto checksum = Checksum(payload, size, Checksum(header, headerSize));
+   mFile.Write({reinterpret_cast<const Letter*>(header), headerSize});
+   if (size)
+      mFile.Write({static_cast<const Letter*>(payload), size});
+   mFile.Write({reinterpret_cast<const Letter*>(&checksum), sizeof(checksum)});
+}
+
+/// Write a text or style record                                              
+///   @param type - the type of the record                                    
+///   @param style - the style id                                             
+///   @param payload - the data after the header                              
+///   @param size - number of bytes in the payload                            
+void BinaryWriter::WriteBlock(BinaryType type, uint32_t style, const void* payload, size_t size) noexcept {
+   uint8_t header[BinaryMaxHeader];
+   size_t used = 0;
+   header[used++] = static_cast<uint8_t>(type);
+   used += PutVarint(header + used, style);
+   used += PutVarint(header + used, size);
+   WriteRecord(header, used, payload, size);
+}
+
+/// Get the id of a style, defining it in the file, if it's new               
+///   @param style - the style                                                
+///   @return the id of the style                                             
+uint32_t BinaryWriter::DefineStyle(const Style& style) noexcept {
+   const PackedStyle packed {style};
+   for (size_t i = 0; i < mStyles.size(); ++i) {
+      if (mStyles[i] == packed)
+         return static_cast<uint32_t>(i);
+   }
+
+   // Ids are reused if there are too many styles, which is fine,       
+   // because definitions always precede the records that use them      
+   if (mStyles.size() >= MaxStyles)
+      mStyles.clear();
+
+   try { mStyles.push_back(packed); }
+   catch (...) { return 0; }
+
+   const auto id = static_cast<uint32_t>(mStyles.size() - 1);
+   WriteBlock(BinaryType::Stylize, id, &packed, sizeof(packed));
+   return id;
+}
+
+/// Append text to the pending text record, writing it first if it has a      
+/// different style, or gets too big                                          
+///   @param text - the text to append                                        
+void BinaryWriter::Write(const TextView& text) noexcept {
+   if (not mPending.empty() and (mPendingStyle != mStyle
+   or  mPending.size() + text.size() > MaxTextRecord))
+      WritePending();
+
+   if (text.size() > MaxTextRecord) {
+      // Too big to be merged with anything                             
+      WriteBlock(BinaryType::Text, mStyle, text.data(), text.size());
+      return;
+   }
+
+   mPendingStyle = mStyle;
+   try { mPending += text; }
+   catch (...) {}
+}
+
+/// Change the style of the text that follows                                 
+///   @param style - the style                                                
+void BinaryWriter::Write(const Style& style) noexcept {
+   const PackedStyle packed {style};
+   if (mStyle < mStyles.size() and mStyles[mStyle] == packed)
+      return;
+
+   WritePending();
+   mStyle = DefineStyle(style);
+}
+
+/// Write a new line record, with the current time, intent, tabs and style    
+void BinaryWriter::NewLine() noexcept {
+   Commit();
+   mFile.BeginLine(Instance.GetIntent());
+
+   mStyle = DefineStyle(Instance.GetCurrentStyle());
+   const int64_t time = ::std::chrono::duration_cast<::std::chrono::nanoseconds>(
+      Instance.GetLineTime().time_since_epoch()).count();
+
+   uint8_t header[BinaryMaxHeader];
+   size_t used = 0;
+   header[used++] = static_cast<uint8_t>(BinaryType::NewLine);
+   used += PutVarint(header + used, mStyle);
+   header[used++] = static_cast<uint8_t>(Instance.GetIntent());
+   used += PutVarint(header + used, Instance.GetTabs());
+   used += PutVarint(header + used, ZigZag(time - mLastTime));
+   WriteRecord(header, used, nullptr, 0);
+   mLastTime = time;
+}
+
+/// End the previous line, writing the file and rotating it, as the policy    
+/// says                                                                      
+void BinaryWriter::Commit() noexcept {
+   WritePending();
+
+   mFile.Commit(true);
+   if (mFile.IsRotationDue()) {
+      mFile.Rotate();
+      WriteHeader();
+   }
+}
+
+/// Discard everything written so far                                         
+void BinaryWriter::Clear() noexcept {
+   mPending.clear();
+   mFile.Truncate();
+   WriteHeader();
+}
+
+/// Write the pending text record, and everything buffered                    
+void BinaryWriter::Flush() noexcept {
+   WritePending();
+   mFile.Flush();
+}
+
+/// Write the pending text record, if any                                     
+void BinaryWriter::WritePending() noexcept {
+   if (mPending.empty())
+      return;
+
+   WriteBlock(BinaryType::Text, mPendingStyle, mPending.data(), mPending.size());
+   mPending.clear();
+}
+
+
+/// Create a binary file duplicator/redirector                                
+///   @param filename - the relative filename of the log file                 
+///   @param policy - buffering, flushing, syncing and rotation policy        
+ToBinary::ToBinary(const TextView& filename, const FilePolicy& policy)
+   : mWriter {::std::make_unique<Inner::BinaryWriter>(filename, policy)} {}
+
+ToBinary::~ToBinary() = default;
+
+/// Write text                                                                
+///   @param text - the text to append to the file                            
+void ToBinary::Write(const TextView& text) const noexcept {
+   mWriter->Write(text);
+}
+
+/// Change the style of the text that follows                                 
+///   @param style - the style to set                                         
+void ToBinary::Write(Style style) const noexcept {
+   mWriter->Write(style);
+}
+
+/// Start a new line                                                          
+void ToBinary::NewLine() const noexcept {
+   mWriter->NewLine();
+}
+
+/// Clear the log file                                                        
+void ToBinary::Clear() const noexcept {
+   mWriter->Clear();
+}
+
+/// Write anything that is buffered to the file                               
+void ToBinary::Flush() const noexcept {
+   mWriter->Flush();
+}
+
+
+/// Decode a binary log, replaying it into an attachment, as if it was logged 
+/// Use it with ToTXT or ToHTML to get the same output they'd have produced   
+/// Decoding stops at the end of the file, or at the first damaged record     
+///   @param filename - the binary log file                                   
+///   @param sink - the attachment to write to                                
+///   @return the number of decoded records                                   
+size_t Logger::DecodeBinary(const TextView& filename, const A::Interface& sink) {
+   ::std::ifstream file {::std::string {filename}, ::std::ios::binary};
+   ::std::array<Letter, BinaryMagic.size()> magic {};
+   if (not file.read(magic.data(), magic.size()) or magic != BinaryMagic)
+      return 0;
+
+   // Records set up the thread's context, give it back when done       
+   const SavedContext saved;
+
+   ::std::vector<PackedStyle> styles;
+   ::std::string payload;
+   uint8_t header[BinaryMaxHeader];
+   size_t used = 0;
+   int64_t time = 0;
+   int64_t applied = -1;
+   size_t count = 0;
+
+   // Read a byte of the header                                         
+   const auto readByte = [&](uint8_t& to) {
+      const auto c = file.get();
+      if (c == ::std::ifstream::traits_type::eof() or used == sizeof(header))
+         return false;
+      to = header[used++] = static_cast<uint8_t>(c);
+      return true;
+   };
+
+   // Read a varint of the header                                       
+   const auto readVarint = [&](uint64_t& to) {
+      to = 0;
+      uint8_t byte;
+      for (int shift = 0; shift < 64; shift += 7) {
+         if (not readByte(byte))
+            return false;
+         to |= static_cast<uint64_t>(byte & 0x7F) << shift;
+         if (not (byte & 0x80))
+            return true;
+      }
+      return false;
+   };
+
+   while (true) {
+      uint8_t type;
+      used = 0;
+      if (not readByte(type))
+         break;
+
+      uint64_t style = 0, size = 0, tabs = 0, delta = 0;
+      uint8_t intent = 0;
+
+      switch (static_cast<BinaryType>(type)) {
+      case BinaryType::Text:
+      case BinaryType::Stylize:
+         if (not readVarint(style) or not readVarint(size) or size > 0xFFFFFFFF)
+            return count;
+         break;
+      case BinaryType::NewLine:
+         if (not readVarint(style) or not readByte(intent)
+         or  not readVarint(tabs) or not readVarint(delta))
+            return count;
+         break;
+      default:
+         return count;
+      }
+
+      uint32_t checksum;
+      try { payload.resize(size); }
+      catch (...) { return count; }
+      if ((size and not file.read(payload.data(), size))
+      or  not file.read(reinterpret_cast<Letter*>(&checksum), sizeof(checksum)))
+         return count;
+      if (checksum != Checksum(payload.data(), size, Checksum(header, used)))
+         return count;
+
+      if (type == static_cast<uint8_t>(BinaryType::Stylize)) {
+         if (size != sizeof(PackedStyle) or style >= MaxStyles)
+            return count;
+         if (style >= styles.size())
+            styles.resize(style + 1);
+         ::std::memcpy(&styles[style], payload.data(), sizeof(PackedStyle));
+         if (static_cast<int64_t>(style) == applied)
+            applied = -1;
+         ++count;
+         continue;
+      }
+
+      if (style >= styles.size())
+         return count;
+
+      Record record;
+      record.size = 0;
+      record.style = styles[style].Unpack();
+
+      if (type == static_cast<uint8_t>(BinaryType::Text)) {
+         if (static_cast<int64_t>(style) != applied) {
+            // The rest of the context is kept from the line            
+            record.type = Record::Stylize;
+            record.intent = Instance.GetIntent();
+            record.tabs = static_cast<uint32_t>(Instance.GetTabs());
+            UseContext(record);
+            sink.Write(record.style);
+            applied = static_cast<int64_t>(style);
+         }
+
+         sink.Write(TextView {payload});
+      }
+      else {
+         // Attachments apply the current style by themselves           
+         time += UnZigZag(delta);
+         record.type = Record::NewLine;
+         // Attachments index tables with the intent, so anything out   
+         // of range is ignored, even if the record's checksum is fine  
+         record.intent = intent < static_cast<uint8_t>(Intent::Counter)
+            ? static_cast<Intent>(intent) : Intent::Ignore;
+         record.tabs = static_cast<uint32_t>(tabs);
+         record.time = TimePoint {::std::chrono::duration_cast<TimePoint::duration>(
+            ::std::chrono::nanoseconds {time})};
+         UseContext(record);
+         sink.NewLine();
+         applied = static_cast<int64_t>(style);
+      }
+
+      ++count;
+   }
+
+   return count;
+}
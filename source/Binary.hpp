@@ -0,0 +1,97 @@
+///                                                                           
+/// Langulus::Logger                                                          
+/// Copyright (c) 2012 Dimo Markov <team@langulus.com>                        
+/// Part of the Langulus framework, see https://langulus.com                  
+///                                                                           
+/// SPDX-License-Identifier: MIT                                              
+///                                                                           
+#pragma once
+#include "FileWriter.hpp"
+#include <array>
+#include <vector>
+
+
+namespace Langulus::Logger::Inner
+{
+
+   /// Every binary log starts with these bytes, the last one is the version  
+   constexpr ::std::array<Letter, 8> BinaryMagic {'L', 'G', 'L', 'O', 'G', 'B', '\n', 1};
+
+   ///                                                                        
+   /// Types of records in a binary log. Each record ends with a CRC-32 of    
+   /// all its previous bytes. Integers marked with * are LEB128 varints, the 
+   /// rest are in the byte order of the machine that wrote the log:          
+   ///    Text     type:u8 style:* size:* payload[size] crc:u32               
+   ///    Stylize  type:u8 style:* size:* payload[size] crc:u32               
+   ///    NewLine  type:u8 style:* intent:u8 tabs:* time:* crc:u32            
+   /// Text is UTF-8 in the given style, and it belongs to the line that was  
+   /// last started. Stylize defines the style with the given id, and its     
+   /// payload is a PackedStyle. NewLine starts a line, its time is the       
+   /// zigzag-encoded difference in nanoseconds from the previous line, or    
+   /// from the epoch for the first line in the file                          
+   ///                                                                        
+   enum class BinaryType : uint8_t {
+      Text, NewLine, Stylize
+   };
+
+   /// Longest possible record header                                         
+   constexpr size_t BinaryMaxHeader = 1 + 10 + 1 + 10 + 10;
+
+   ///                                                                        
+   /// A style, in the form it is written to a binary log                     
+   ///                                                                        
+   struct PackedStyle {
+      enum Flags : uint8_t {
+         HasForeground = 1,
+         ForegroundRGB = 2,
+         HasBackground = 4,
+         BackgroundRGB = 8
+      };
+
+      uint8_t  mEmphasis = 0;
+      uint8_t  mFlags = 0;
+      uint8_t  mReserved[2] {};
+      uint32_t mForeground = 0;
+      uint32_t mBackground = 0;
+
+      PackedStyle() noexcept = default;
+      PackedStyle(const Style&) noexcept;
+
+      Style Unpack() const noexcept;
+      bool operator == (const PackedStyle&) const noexcept = default;
+   };
+
+   uint32_t Checksum(const void*, size_t, uint32_t = 0) noexcept;
+
+
+   ///                                                                        
+   /// Encodes logging messages into framed binary records, merging           
+   /// consecutive text of the same style into a single record                
+   ///                                                                        
+   class BinaryWriter {
+      FileWriter mFile;
+      ::std::string mPending;
+      uint32_t mPendingStyle = 0;
+      ::std::vector<PackedStyle> mStyles;
+      uint32_t mStyle = 0;
+      int64_t mLastTime = 0;
+
+      void WriteRecord(const uint8_t*, size_t, const void*, size_t) noexcept;
+      void WriteBlock(BinaryType, uint32_t, const void*, size_t) noexcept;
+      void WritePending() noexcept;
+      uint32_t DefineStyle(const Style&) noexcept;
+
+   public:
+      BinaryWriter(const TextView&, const FilePolicy&);
+      ~BinaryWriter();
+
+      void WriteHeader() noexcept;
+      void Write(const TextView&) noexcept;
+      void Write(const Style&) noexcept;
+      void NewLine() noexcept;
+      void Clear() noexcept;
+      void Flush() noexcept;
+      void Commit() noexcept;
+   };
+
+} // namespace Langulus::Logger::Inner
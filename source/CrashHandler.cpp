@@ -0,0 +1,189 @@
+///                                                                           
+/// Langulus::Logger                                                          
+/// Copyright (c) 2012 Dimo Markov <team@langulus.com>                        
+/// Part of the Langulus framework, see https://langulus.com                  
+///                                                                           
+/// SPDX-License-Identifier: MIT                                              
+///                                                                           
+#include "FileWriter.hpp"
+#include <csignal>
+
+#ifndef _WIN32
+   #include <time.h>
+#endif
+
+using namespace Langulus;
+using namespace Langulus::Logger;
+using namespace Langulus::Logger::Inner;
+
+
+///                                                                           
+/// Salvages buffered logs when the process crashes, using only calls that    
+/// are safe in a signal handler, and then hands the signal over to the       
+/// handler that was installed before                                         
+///                                                                           
+struct Inner::CrashHandler {
+#ifdef _WIN32
+   static constexpr int Signals[] {SIGSEGV, SIGFPE, SIGILL, SIGABRT, SIGTERM};
+   using Action = void(*)(int);
+#else
+   static constexpr int Signals[] {SIGSEGV, SIGBUS, SIGFPE, SIGILL, SIGABRT, SIGTERM};
+   using Action = struct sigaction;
+#endif
+
+   static constexpr size_t Count = sizeof(Signals) / sizeof(*Signals);
+
+   // Handlers, that were installed before, for each of the signals     
+   static inline Action sPrevious[Count] {};
+   static inline ::std::atomic<bool> sInstalled {};
+   // How long salvaging may take, in nanoseconds                       
+   static inline ::std::atomic<int64_t> sBudget {};
+   // Raised by the first crashing thread, and when it is done          
+   static inline ::std::atomic<bool> sSalvaging {};
+   static inline ::std::atomic<bool> sSalvaged {};
+
+#ifndef _WIN32
+   // Stack for the handler, so that a stack overflow can be salvaged   
+   alignas(16) static inline char sStack[64 * 1024] {};
+#endif
+
+   /// Read the monotonic clock, in a way that is safe in a signal handler    
+   ///   @return the time in nanoseconds                                      
+   static int64_t Now() noexcept {
+   #ifdef _WIN32
+      return ::std::chrono::duration_cast<::std::chrono::nanoseconds>(
+         ::std::chrono::steady_clock::now().time_since_epoch()).count();
+   #else
+      ::timespec time {};
+      ::clock_gettime(CLOCK_MONOTONIC, &time);
+      return static_cast<int64_t>(time.tv_sec) * 1'000'000'000 + time.tv_nsec;
+   #endif
+   }
+
+   /// Write everything buffered, then terminate and sync the files, giving   
+   /// up when the budget runs out. Threads that crash at the same time wait  
+   /// for the first one, within the same budget                              
+   static void Salvage() noexcept {
+      const auto deadline = Now() + sBudget.load(::std::memory_order_relaxed);
+      if (sSalvaging.exchange(true)) {
+         while (not sSalvaged.load() and Now() < deadline);
+         return;
+      }
+
+      Instance.Salvage();
+
+      // Writing buffers comes first, syncing is slow and is cut short  
+      for (size_t i = 0; i < FileWriter::MaxRegistered and Now() < deadline; ++i) {
+         if (auto file = FileWriter::GetRegistered(i))
+            file->Salvage();
+      }
+
+      for (size_t i = 0; i < FileWriter::MaxRegistered and Now() < deadline; ++i) {
+         if (auto file = FileWriter::GetRegistered(i))
+            file->Sync();
+      }
+
+      sSalvaged.store(true);
+   }
+
+   /// Get the index of a signal                                              
+   ///   @param signal - the signal                                           
+   ///   @return the index in Signals                                         
+   static size_t IndexOf(int signal) noexcept {
+      size_t index = 0;
+      while (index < Count - 1 and Signals[index] != signal)
+         ++index;
+      return index;
+   }
+
+#ifdef _WIN32
+   /// Salvage, and chain to the previous handler                             
+   ///   @param signal - the signal that was raised                           
+   static void Handle(int signal) {
+      Salvage();
+
+      const auto previous = sPrevious[IndexOf(signal)];
+      ::std::signal(signal, previous);
+      if (previous == SIG_DFL)
+         ::std::raise(signal);
+      else if (previous != SIG_IGN and previous != SIG_ERR)
+         previous(signal);
+   }
+#else
+   /// Salvage, and chain to the previous handler. If that was the default    
+   /// action, it is restored, and the signal is raised again, taking effect  
+   /// as soon as this handler returns                                        
+   ///   @param signal - the signal that was raised                           
+   ///   @param info - details about the signal                               
+   ///   @param context - the interrupted context                             
+   static void Handle(int signal, ::siginfo_t* info, void* context) {
+      Salvage();
+
+      const auto& previous = sPrevious[IndexOf(signal)];
+      if (previous.sa_handler == SIG_DFL) {
+         ::sigaction(signal, &previous, nullptr);
+         ::raise(signal);
+      }
+      else if (previous.sa_handler == SIG_IGN)
+         return;
+      else if (previous.sa_flags & SA_SIGINFO)
+         previous.sa_sigaction(signal, info, context);
+      else
+         previous.sa_handler(signal);
+   }
+#endif
+};
+
+
+/// Install a handler for crash signals, that writes whatever logs are still  
+/// buffered, terminates html logs, and syncs log files, before handing the   
+/// signal over to the previously installed handler. The whole lines of all   
+/// threads' console output are salvaged, but only the crashing thread's      
+/// unfinished line, and the text of records waiting in the async queue goes  
+/// to stderr, because it can't be dispatched safely. The calling thread gets 
+/// an alternate stack for the handler, unless it has one - other threads     
+/// handle crashes on their own stacks, so their stack overflows are lost     
+///   @param budget - how long salvaging may take                             
+void Logger::InstallCrashHandler(::std::chrono::milliseconds budget) noexcept {
+   CrashHandler::sBudget.store(::std::chrono::duration_cast<
+      ::std::chrono::nanoseconds>(budget).count());
+   if (CrashHandler::sInstalled.exchange(true))
+      return;
+
+#ifdef _WIN32
+   for (size_t i = 0; i < CrashHandler::Count; ++i) {
+      CrashHandler::sPrevious[i] = ::std::signal(
+         CrashHandler::Signals[i], &CrashHandler::Handle);
+   }
+#else
+   struct sigaction action {};
+   action.sa_sigaction = &CrashHandler::Handle;
+   action.sa_flags = SA_SIGINFO | SA_ONSTACK;
+   ::sigemptyset(&action.sa_mask);
+   for (size_t i = 0; i < CrashHandler::Count; ++i)
+      ::sigaction(CrashHandler::Signals[i], &action, &CrashHandler::sPrevious[i]);
+
+   // SA_ONSTACK does nothing without an alternate stack                
+   ::stack_t current {};
+   if (::sigaltstack(nullptr, &current) == 0 and (current.ss_flags & SS_DISABLE)) {
+      ::stack_t stack {};
+      stack.ss_sp = CrashHandler::sStack;
+      stack.ss_size = sizeof(CrashHandler::sStack);
+      ::sigaltstack(&stack, nullptr);
+   }
+#endif
+}
+
+/// Restore the handlers, that were installed before InstallCrashHandler      
+void Logger::UninstallCrashHandler() noexcept {
+   if (not CrashHandler::sInstalled.exchange(false))
+      return;
+
+   for (size_t i = 0; i < CrashHandler::Count; ++i) {
+   #ifdef _WIN32
+      ::std::signal(CrashHandler::Signals[i], CrashHandler::sPrevious[i]);
+   #else
+      ::sigaction(CrashHandler::Signals[i], &CrashHandler::sPrevious[i], nullptr);
+   #endif
+   }
+}
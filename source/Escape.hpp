@@ -0,0 +1,119 @@
+///                                                                           
+/// Langulus::Logger                                                          
+/// Copyright (c) 2012 Dimo Markov <team@langulus.com>                        
+/// Part of the Langulus framework, see https://langulus.com                  
+///                                                                           
+/// SPDX-License-Identifier: MIT                                              
+///                                                                           
+#pragma once
+#include "Logger.hpp"
+#include <array>
+#include <cstring>
+
+
+namespace Langulus::Logger::Inner
+{
+
+   /// Parameters of an ANSI select graphic rendition (SGR) escape sequence   
+   struct Sgr {
+      // Big enough for all emphasis codes, or an RGB color             
+      Letter mText[20] {};
+      uint8_t mSize = 0;
+
+      /// Append a parameter, prefixed with a separator                       
+      ///   @param code - the parameter, must be less than 1000               
+      constexpr void Append(unsigned code) noexcept {
+         mText[mSize++] = ';';
+         if (code >= 100)
+            mText[mSize++] = static_cast<Letter>('0' + code / 100);
+         if (code >= 10)
+            mText[mSize++] = static_cast<Letter>('0' + code / 10 % 10);
+         mText[mSize++] = static_cast<Letter>('0' + code % 10);
+      }
+   };
+
+   /// Parameters for each combination of emphasis bits                       
+   constexpr auto EmphasisSgr = [] {
+      // SGR code for each fmt::emphasis bit, from the lowest bit       
+      constexpr unsigned codes[8] = {1, 2, 3, 4, 5, 7, 8, 9};
+      ::std::array<Sgr, 256> table;
+      for (unsigned bits = 0; bits < 256; ++bits) {
+         for (unsigned bit = 0; bit < 8; ++bit) {
+            if (bits & (1u << bit))
+               table[bits].Append(codes[bit]);
+         }
+      }
+      return table;
+   }();
+
+   /// Parameters for each terminal color, indexed by its foreground code     
+   /// Background codes are the same, only shifted by 10                      
+   template<unsigned SHIFT>
+   constexpr auto TerminalSgr = [] {
+      ::std::array<Sgr, 128> table;
+      for (unsigned code = 30; code < 38; ++code) {
+         table[code].Append(code + SHIFT);
+         table[code + 60].Append(code + 60 + SHIFT);
+      }
+      return table;
+   }();
+
+   /// A complete escape sequence, that resets the previous style, and sets the
+   /// new one, so that it can be written with a single call                  
+   struct Escape {
+      Letter mText[64];
+      uint8_t mSize = 0;
+
+      /// Build the sequence from the precomputed tables                      
+      ///   @param style - the style to set                                   
+      Escape(const Style& style) noexcept {
+         // Always reset before a style change                          
+         Append("\x1b[0", 3);
+
+         if (style.has_emphasis()) {
+            const auto& e = EmphasisSgr[static_cast<uint8_t>(style.get_emphasis())];
+            Append(e.mText, e.mSize);
+         }
+
+         if (style.has_foreground())
+            Append<0>(style.get_foreground());
+         if (style.has_background())
+            Append<10>(style.get_background());
+
+         Append("m", 1);
+      }
+
+      /// Get the sequence                                                    
+      TextView View() const noexcept {
+         return {mText, mSize};
+      }
+
+   private:
+      void Append(const Letter* text, size_t size) noexcept {
+         ::std::memcpy(mText + mSize, text, size);
+         mSize += static_cast<uint8_t>(size);
+      }
+
+      /// Append a color - terminal colors come from the table, while RGB     
+      /// colors are the only parameters that are generated on the fly        
+      ///   @tparam SHIFT - 0 for foreground, 10 for background               
+      template<unsigned SHIFT, class T>
+      void Append(const T& color) noexcept {
+         if (not color.is_rgb) {
+            const auto& t = TerminalSgr<SHIFT>[color.value.term_color & 127];
+            Append(t.mText, t.mSize);
+            return;
+         }
+
+         const auto rgb = color.value.rgb_color;
+         Sgr t;
+         t.Append(38 + SHIFT);
+         t.Append(2);
+         t.Append((rgb >> 16) & 0xFF);
+         t.Append((rgb >> 8) & 0xFF);
+         t.Append(rgb & 0xFF);
+         Append(t.mText, t.mSize);
+      }
+   };
+
+} // namespace Langulus::Logger::Inner
@@ -0,0 +1,442 @@
+///                                                                           
+/// Langulus::Logger                                                          
+/// Copyright (c) 2012 Dimo Markov <team@langulus.com>                        
+/// Part of the Langulus framework, see https://langulus.com                  
+///                                                                           
+/// SPDX-License-Identifier: MIT                                              
+///                                                                           
+#include "FileWriter.hpp"
+#include <cerrno>
+#include <cstring>
+#include <new>
+#include <stdexcept>
+#include <filesystem>
+
+#ifdef _WIN32
+   #include <io.h>
+   #include <fcntl.h>
+   #include <sys/stat.h>
+#else
+   #include <unistd.h>
+   #include <fcntl.h>
+#endif
+
+using namespace Langulus;
+using namespace Langulus::Logger;
+using namespace Langulus::Logger::Inner;
+
+/// Buffers are aligned to, and sized in whole pages                          
+constexpr size_t PageSize = 4096;
+
+/// Suffix for the file, that is opened ahead of rotation                     
+constexpr TextView SpareSuffix = ".next";
+
+/// Every file writer, that is alive                                          
+::std::atomic<FileWriter*> gRegistered[FileWriter::MaxRegistered] {};
+
+/// Check if lines of an intent are synced under FilePolicy::SyncErrors       
+///   @param intent - the intent to check                                     
+///   @return true if intent is Error or FatalError                           
+constexpr bool IsErrorIntent(Intent intent) noexcept {
+   return intent == Intent::Error or intent == Intent::FatalError;
+}
+
+/// Open a file for appending, discarding any previous contents               
+///   @param filename - the file to open                                      
+///   @return the file descriptor, or -1 on failure                           
+int OpenFile(const ::std::string& filename) noexcept {
+#ifdef _WIN32
+   return ::_open(filename.c_str(),
+      _O_WRONLY | _O_CREAT | _O_TRUNC | _O_APPEND | _O_BINARY,
+      _S_IREAD | _S_IWRITE);
+#else
+   return ::open(filename.c_str(),
+      O_WRONLY | O_CREAT | O_TRUNC | O_APPEND | O_CLOEXEC, 0644);
+#endif
+}
+
+/// Write all of the data to a file, with raw writes only                     
+///   @param file - the file descriptor                                       
+///   @param data - the data to write                                         
+///   @param size - the number of bytes                                       
+///   @return the number of bytes that were written                           
+size_t WriteAll(int file, const Letter* data, size_t size) noexcept {
+   const auto total = size;
+   while (size) {
+#ifdef _WIN32
+      const auto written = ::_write(file, data,
+         static_cast<unsigned>(::std::min<size_t>(size, 1 << 30)));
+#else
+      const auto written = ::write(file, data, size);
+#endif
+      if (written < 0) {
+         if (errno == EINTR)
+            continue;
+         break;
+      }
+
+      data += written;
+      size -= static_cast<size_t>(written);
+   }
+   return total - size;
+}
+
+/// Give back the disk space, that was reserved beyond the written data       
+///   @param file - the file descriptor                                       
+///   @param written - the size of the file                                   
+///   @param reserved - the size of the file, including the reserved space    
+void ReleaseReserved([[maybe_unused]] int file,
+   [[maybe_unused]] size_t written, [[maybe_unused]] size_t reserved) noexcept {
+#if defined(__linux__) and defined(FALLOC_FL_PUNCH_HOLE)
+   if (reserved <= written)
+      return;
+
+   [[maybe_unused]] auto result = ::fallocate(file,
+      FALLOC_FL_PUNCH_HOLE | FALLOC_FL_KEEP_SIZE,
+      static_cast<off_t>(written), static_cast<off_t>(reserved - written));
+#endif
+}
+
+/// Close a file                                                              
+///   @param file - the file descriptor                                       
+///   @param sync - whether to sync it before closing                         
+void CloseFile(int file, bool sync) noexcept {
+#ifdef _WIN32
+   if (sync)
+      ::_commit(file);
+   ::_close(file);
+#else
+   if (sync)
+      ::fsync(file);
+   ::close(file);
+#endif
+}
+
+
+/// Open the file for appending, discarding any previous contents             
+///   @param filename - the relative filename of the log file                 
+///   @param policy - buffering, flushing and syncing policy                  
+FileWriter::FileWriter(const TextView& filename, const FilePolicy& policy)
+   : mFilename {filename}
+   , mPolicy   {policy}
+   , mLastFlush {::std::chrono::steady_clock::now()}
+   , mSegmentStart {mLastFlush} {
+   mFile = OpenFile(mFilename);
+   if (mFile < 0)
+      throw std::runtime_error {"Can't open log file"};
+
+#ifndef _WIN32
+   // Open the next file ahead of time, so that rotating is just a swap 
+   if (mPolicy.rotateSize or mPolicy.rotateInterval.count())
+      mSpare = OpenFile(mFilename + ::std::string {SpareSuffix});
+#endif
+
+   mCapacity = (::std::max<size_t>(mPolicy.buffer, 1) + PageSize - 1)
+      / PageSize * PageSize;
+   mBuffer = static_cast<Letter*>(::operator new(
+      mCapacity, ::std::align_val_t {PageSize}, ::std::nothrow));
+   if (not mBuffer)
+      mCapacity = 0;
+
+   for (auto& slot : gRegistered) {
+      FileWriter* empty = nullptr;
+      if (slot.compare_exchange_strong(empty, this))
+         break;
+   }
+
+   // Nothing else watches the time, while nothing is logged            
+   if (mPolicy.flush.mode == FlushPolicy::Interval) {
+      try { mFlusher = ::std::thread {&FileWriter::RunFlusher, this}; }
+      catch (...) {}
+   }
+}
+
+/// Write whatever is buffered, and close the file                            
+FileWriter::~FileWriter() {
+   for (auto& slot : gRegistered) {
+      FileWriter* self = this;
+      if (slot.compare_exchange_strong(self, nullptr))
+         break;
+   }
+
+   if (mFlusher.joinable()) {
+      {
+         const ::std::scoped_lock lock {mMutex};
+         mStopping = true;
+      }
+      mFlusherWake.notify_one();
+      mFlusher.join();
+   }
+
+   Flush();
+   ReleaseReserved(mFile, mWritten, mReserved);
+   CloseFile(mFile, mPolicy.sync != FilePolicy::NeverSync);
+
+   if (mRotator.joinable())
+      mRotator.join();
+
+   if (mSpare >= 0) {
+      CloseFile(mSpare, false);
+      ::std::error_code error;
+      ::std::filesystem::remove(mFilename + ::std::string {SpareSuffix}, error);
+   }
+
+   if (mBuffer)
+      ::operator delete(mBuffer, ::std::align_val_t {PageSize});
+}
+
+/// Append text to the buffer, writing the buffer if it gets full             
+///   @param text - the text to append                                        
+void FileWriter::Write(const TextView& text) noexcept {
+   const ::std::scoped_lock lock {mMutex};
+   if (mUsed + text.size() > mCapacity) {
+      FlushBuffer();
+
+      if (text.size() > mCapacity) {
+         // Doesn't fit at all, so write it directly                    
+         WriteToFile(text.data(), text.size());
+         return;
+      }
+   }
+
+   ::std::memcpy(mBuffer + mUsed, text.data(), text.size());
+   mUsed += text.size();
+}
+
+/// Start buffering a new line - call it after committing the previous one,   
+/// so that flushing and syncing depend on the intent of the line that ended  
+///   @param intent - the intent of the new line                              
+void FileWriter::BeginLine(Intent intent) noexcept {
+   const ::std::scoped_lock lock {mMutex};
+   mLineIntent = intent;
+   if (IsErrorIntent(intent))
+      mErrorsPending = true;
+}
+
+/// Write the buffer, if the flush policy says so                             
+///   @param endOfLine - whether a line has just ended                        
+void FileWriter::Commit(bool endOfLine) noexcept {
+   const ::std::scoped_lock lock {mMutex};
+   if (mUsed == 0)
+      return;
+
+   const auto elapsed = ::std::chrono::steady_clock::now() - mLastFlush;
+   if (mPolicy.flush.IsDue(mUsed, elapsed, endOfLine, mLineIntent))
+      FlushBuffer();
+}
+
+/// Write the buffer to the file, and sync it, if the policy says so          
+void FileWriter::Flush() noexcept {
+   const ::std::scoped_lock lock {mMutex};
+   FlushBuffer();
+}
+
+/// Write the buffer in the background, as soon as the interval passes since  
+/// it was last written, so that the end of a quiet log isn't held back       
+void FileWriter::RunFlusher() noexcept {
+   const auto interval = ::std::max<::std::chrono::steady_clock::duration>(
+      mPolicy.flush.interval, ::std::chrono::milliseconds {1});
+
+   ::std::unique_lock lock {mMutex};
+   while (not mStopping) {
+      const auto now = ::std::chrono::steady_clock::now();
+      if (mUsed and now - mLastFlush >= interval)
+         FlushBuffer();
+
+      mFlusherWake.wait_until(lock, mUsed ? mLastFlush + interval : now + interval);
+   }
+}
+
+/// Write the buffer to the file - lock mMutex first                          
+void FileWriter::FlushBuffer() noexcept {
+   if (mUsed) {
+      WriteToFile(mBuffer, mUsed);
+      mUsed = 0;
+   }
+
+   mLastFlush = ::std::chrono::steady_clock::now();
+}
+
+/// Discard the buffer and all contents of the file                           
+void FileWriter::Truncate() noexcept {
+   const ::std::scoped_lock lock {mMutex};
+   mUsed = 0;
+   mWritten = 0;
+   mReserved = 0;
+
+#ifdef _WIN32
+   [[maybe_unused]] auto result = ::_chsize_s(mFile, 0);
+#else
+   [[maybe_unused]] auto result = ::ftruncate(mFile, 0);
+#endif
+}
+
+/// Check if the current file is big or old enough to be rotated              
+///   @return true if Rotate() should be called at the next line boundary     
+bool FileWriter::IsRotationDue() const noexcept {
+   const ::std::scoped_lock lock {mMutex};
+   if (mPolicy.rotateSize and mWritten + mUsed >= mPolicy.rotateSize)
+      return true;
+
+   const auto age = ::std::chrono::steady_clock::now() - mSegmentStart;
+   return mPolicy.rotateInterval.count() and age >= mPolicy.rotateInterval;
+}
+
+/// Continue writing in a new file. The caller only swaps in the file that    
+/// was opened ahead of time - closing, renaming, enforcing retention, and    
+/// opening the next file happen in the background                            
+///   @attention the owner is responsible for writing footers and headers     
+void FileWriter::Rotate() noexcept {
+   const ::std::scoped_lock lock {mMutex};
+   FlushBuffer();
+
+   // Wait for the previous rotation, in the rare case it's not done    
+   if (mRotator.joinable())
+      mRotator.join();
+
+   // The previous file's unused reservation is given back here, the    
+   // background thread only closes and renames the file                
+   const int previous = mFile;
+   ReleaseReserved(previous, mWritten, mReserved);
+   mWritten = mReserved = 0;
+   mSegmentStart = ::std::chrono::steady_clock::now();
+
+   if (mSpare >= 0) {
+      // The spare file becomes the current one, and the rest happens   
+      // in the background                                              
+      mFile = mSpare;
+      mSpare = -1;
+
+      const auto finish = [this, previous] {
+         Retire(previous);
+         const auto spare = mFilename + ::std::string {SpareSuffix};
+         ::std::error_code error;
+         ::std::filesystem::rename(spare, mFilename, error);
+         mSpare = OpenFile(spare);
+      };
+
+      try { mRotator = ::std::thread {finish}; }
+      catch (...) { finish(); }
+      return;
+   }
+
+   // Open files can't be renamed on some systems, so this is done in   
+   // place, after closing the previous file                            
+   Retire(previous);
+   const int next = OpenFile(mFilename);
+   if (next >= 0)
+      mFile = next;
+}
+
+/// Close the previous file, and shift it into the sequence of old files,     
+/// removing any that exceed the retention limit                              
+///   @param file - the previous file's descriptor                            
+void FileWriter::Retire(int file) noexcept {
+   namespace fs = ::std::filesystem;
+   CloseFile(file, mPolicy.sync != FilePolicy::NeverSync);
+
+   try {
+      ::std::error_code error;
+      size_t free = 1;
+      while (fs::exists(GetRotatedName(free), error))
+         ++free;
+
+      if (mPolicy.rotateKeep) {
+         for (size_t i = mPolicy.rotateKeep; i < free; ++i)
+            fs::remove(GetRotatedName(i), error);
+         free = ::std::min(free, mPolicy.rotateKeep);
+      }
+
+      for (size_t i = free; i > 1; --i)
+         fs::rename(GetRotatedName(i - 1), GetRotatedName(i), error);
+      fs::rename(mFilename, GetRotatedName(1), error);
+   }
+   catch (...) {}
+}
+
+/// Get the name of an old file                                               
+///   @param index - the index of the file, 1 being the most recent           
+///   @return the name, with the index inserted before the extension          
+::std::string FileWriter::GetRotatedName(size_t index) const {
+   const ::std::filesystem::path path {mFilename};
+   auto name = path.stem().string();
+   name += '.';
+   name += ::std::to_string(index);
+   name += path.extension().string();
+   return (path.parent_path() / name).string();
+}
+
+/// Write directly to the file                                                
+///   @param data - the data to write                                         
+///   @param size - number of bytes to write                                  
+void FileWriter::WriteToFile(const Letter* data, size_t size) noexcept {
+   Preallocate(size);
+   mWritten += WriteAll(mFile, data, size);
+
+   // Errors are synced once, when the data that contains them is       
+   // written, and the rest of an unfinished error line stays pending   
+   const bool sync = mPolicy.sync == FilePolicy::AlwaysSync
+      or (mPolicy.sync == FilePolicy::SyncErrors and mErrorsPending);
+   mErrorsPending = IsErrorIntent(mLineIntent);
+   if (sync)
+      Sync();
+}
+
+/// Set text, that terminates the file properly, if the process crashes       
+///   @param footer - the text to write after whatever is buffered            
+void FileWriter::SetEmergencyFooter(const TextView& footer) {
+   mFooter = footer;
+}
+
+/// Write whatever is buffered, followed by the emergency footer, with raw    
+/// writes only, so that it can be done from a signal handler                 
+void FileWriter::Salvage() noexcept {
+   if (mFile < 0)
+      return;
+
+   if (mUsed) {
+      mWritten += WriteAll(mFile, mBuffer, mUsed);
+      mUsed = 0;
+   }
+
+   if (not mFooter.empty())
+      WriteAll(mFile, mFooter.data(), mFooter.size());
+}
+
+/// Wait until everything written is on the disk                              
+void FileWriter::Sync() noexcept {
+#ifdef _WIN32
+   ::_commit(mFile);
+#else
+   ::fsync(mFile);
+#endif
+}
+
+/// Get a file writer, that is alive                                          
+///   @param index - the index in the registry, less than MaxRegistered       
+///   @return the file writer, or nullptr if the index isn't used             
+FileWriter* FileWriter::GetRegistered(size_t index) noexcept {
+   return gRegistered[index].load(::std::memory_order_acquire);
+}
+
+/// Reserve disk space ahead of the written data, without changing the file's 
+/// size, so that appending keeps working as usual                            
+///   @param size - number of bytes that are about to be written              
+void FileWriter::Preallocate([[maybe_unused]] size_t size) noexcept {
+#if defined(__linux__) and defined(FALLOC_FL_KEEP_SIZE)
+   if (not mPolicy.preallocate or mWritten + size <= mReserved)
+      return;
+
+   // Files that rotate never grow much beyond their limit              
+   auto chunk = mPolicy.preallocate;
+   if (mPolicy.rotateSize)
+      chunk = ::std::min(chunk, mPolicy.rotateSize);
+
+   const auto reserve = ::std::max(chunk, size);
+   if (::fallocate(mFile, FALLOC_FL_KEEP_SIZE,
+       static_cast<off_t>(mWritten), static_cast<off_t>(reserve)) == 0)
+      mReserved = mWritten + reserve;
+   else
+      mPolicy.preallocate = 0;
+#endif
+}
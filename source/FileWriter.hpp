@@ -0,0 +1,98 @@
+///                                                                           
+/// Langulus::Logger                                                          
+/// Copyright (c) 2012 Dimo Markov <team@langulus.com>                        
+/// Part of the Langulus framework, see https://langulus.com                  
+///                                                                           
+/// SPDX-License-Identifier: MIT                                              
+///                                                                           
+#pragma once
+#include "Logger.hpp"
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+
+
+namespace Langulus::Logger::Inner
+{
+
+   ///                                                                        
+   /// Append-only log file, that collects text in a big page-aligned buffer, 
+   /// and writes it through a raw file descriptor, as the policy says. Safe  
+   /// to use from several threads, except for Salvage                        
+   ///                                                                        
+   class FileWriter {
+      mutable ::std::mutex mMutex;
+      ::std::string mFilename;
+      FilePolicy mPolicy;
+      int mFile = -1;
+
+      Letter* mBuffer = nullptr;
+      size_t mCapacity = 0;
+      size_t mUsed = 0;
+
+      // Bytes written to the file, and bytes reserved on the disk      
+      size_t mWritten = 0;
+      size_t mReserved = 0;
+
+      // When the buffer was last written                               
+      ::std::chrono::steady_clock::time_point mLastFlush;
+
+      // Intent of the line being buffered, and whether the buffer holds
+      // any errors, that the sync policy cares about                   
+      Intent mLineIntent = Intent::Info;
+      bool mErrorsPending = false;
+
+      // Written after the buffer, when salvaged on a crash             
+      ::std::string mFooter;
+
+      // The next file, opened ahead of rotation, and the thread that   
+      // finishes the previous rotation in the background               
+      int mSpare = -1;
+      ::std::thread mRotator;
+      ::std::chrono::steady_clock::time_point mSegmentStart;
+
+      // Writes the buffer, when the interval of the flush policy passes
+      // without anything else written, only for the Interval mode      
+      ::std::thread mFlusher;
+      ::std::condition_variable mFlusherWake;
+      bool mStopping = false;
+
+      void RunFlusher() noexcept;
+      void FlushBuffer() noexcept;
+      void WriteToFile(const Letter*, size_t) noexcept;
+      void Preallocate(size_t) noexcept;
+      void Retire(int) noexcept;
+      ::std::string GetRotatedName(size_t) const;
+
+   public:
+      FileWriter(const TextView&, const FilePolicy&);
+      ~FileWriter();
+
+      FileWriter(const FileWriter&) = delete;
+      FileWriter& operator = (const FileWriter&) = delete;
+
+      void Write(const TextView&) noexcept;
+      void BeginLine(Intent) noexcept;
+      void Commit(bool endOfLine) noexcept;
+      void Flush() noexcept;
+      void Truncate() noexcept;
+
+      bool IsRotationDue() const noexcept;
+      void Rotate() noexcept;
+
+      void SetEmergencyFooter(const TextView&);
+      void Salvage() noexcept;
+      void Sync() noexcept;
+
+      // File writers are registered, so that they can be salvaged on a 
+      // crash, up to this many                                         
+      static constexpr size_t MaxRegistered = 64;
+      static FileWriter* GetRegistered(size_t) noexcept;
+
+      /// Get the name of the file                                            
+      const ::std::string& GetFilename() const noexcept {
+         return mFilename;
+      }
+   };
+
+} // namespace Langulus::Logger::Inner
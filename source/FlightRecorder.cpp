@@ -0,0 +1,265 @@
+///                                                                           
+/// Langulus::Logger                                                          
+/// Copyright (c) 2012 Dimo Markov <team@langulus.com>                        
+/// Part of the Langulus framework, see https://langulus.com                  
+///                                                                           
+/// SPDX-License-Identifier: MIT                                              
+///                                                                           
+#include "FlightRecorder.hpp"
+#include "Async.hpp"
+#include <csignal>
+#include <cstring>
+#include <utility>
+#include <vector>
+#include <bit>
+
+using namespace Langulus;
+using namespace Langulus::Logger;
+using namespace Langulus::Logger::Inner;
+
+/// Sequence of the line, that the current thread last started in the flight  
+/// recorder, zero if none                                                    
+thread_local uint64_t tFlightLine = 0;
+
+/// Whether the current thread logged a fatal error in its current statement  
+thread_local bool tFlightFatal = false;
+
+/// Raised by the flight recorder's signal                                    
+::std::atomic<bool> gFlightSignaled {};
+
+/// Get the number of slots for a flight recorder                             
+///   @param bytes - the requested size of the flight recorder                
+///   @return the number of slots, a power of two                             
+size_t SlotsFor(size_t bytes) noexcept {
+   return ::std::bit_ceil(::std::max<size_t>(bytes / FlightRecorder::SlotSize, 64));
+}
+
+/// Allocate the ring                                                         
+///   @param bytes - the size of the ring, rounded up to a power of two       
+FlightRecorder::FlightRecorder(size_t bytes)
+   : mSlots {new Slot[SlotsFor(bytes)]}
+   , mMask  {SlotsFor(bytes) - 1} {}
+
+/// Claim a slot for writing, readers skip it until it is written             
+///   @param sequence - the sequence of the slot                              
+///   @return the slot's payload                                              
+auto FlightRecorder::Begin(uint64_t sequence) noexcept -> Payload& {
+   auto& slot = mSlots[sequence & mMask];
+   slot.mSequence.store(0, ::std::memory_order_relaxed);
+   ::std::atomic_thread_fence(::std::memory_order_release);
+   return slot.mPayload;
+}
+
+/// Publish a written slot                                                    
+///   @param sequence - the sequence of the slot                              
+void FlightRecorder::End(uint64_t sequence) noexcept {
+   mSlots[sequence & mMask].mSequence.store(sequence, ::std::memory_order_release);
+}
+
+/// Mark the current thread's statement as fatal, so that the flight          
+/// recorder is dumped when the statement ends, even if fatal errors          
+/// themselves aren't recorded                                                
+void FlightRecorder::MarkFatal() noexcept {
+   tFlightFatal = true;
+}
+
+/// Start a line                                                              
+///   @param intent - the line's intent                                       
+///   @param tabs - the line's tabulation                                     
+///   @param time - when the line was started                                 
+void FlightRecorder::NewLine(Intent intent, uint32_t tabs, TimePoint time) noexcept {
+   const auto sequence = mNext.fetch_add(1, ::std::memory_order_relaxed) + 1;
+   auto& payload = Begin(sequence);
+   payload.mStamp = ::std::chrono::duration_cast<::std::chrono::nanoseconds>(
+      time.time_since_epoch()).count();
+   payload.mType = Payload::NewLine;
+   payload.mIntent = static_cast<uint8_t>(intent);
+   payload.mSize = 0;
+   payload.mTabs = tabs;
+   End(sequence);
+
+   tFlightLine = sequence;
+}
+
+/// Add text to the current thread's line, in as many slots as needed         
+///   @param text - the text to add                                           
+void FlightRecorder::Write(const TextView& text) noexcept {
+   if (not tFlightLine or text.empty())
+      return;
+
+   const auto count = (text.size() + Capacity - 1) / Capacity;
+   auto sequence = mNext.fetch_add(count, ::std::memory_order_relaxed) + 1;
+   for (size_t offset = 0; offset < text.size(); offset += Capacity) {
+      auto& payload = Begin(sequence);
+      payload.mStamp = static_cast<int64_t>(tFlightLine);
+      payload.mType = Payload::Text;
+      payload.mSize = static_cast<uint16_t>(::std::min(text.size() - offset, Capacity));
+      ::std::memcpy(payload.mText, text.data() + offset, payload.mSize);
+      End(sequence++);
+   }
+}
+
+/// Add a value to the current thread's line, formatting it only if the       
+/// flight recorder is ever dumped                                            
+///   @param format - the function that formats the value                     
+///   @param data - the bytes of the value                                    
+///   @param size - the number of bytes, at most MaxDeferredSize              
+void FlightRecorder::WriteDeferred(Formatter format, const void* data, size_t size) noexcept {
+   if (not tFlightLine)
+      return;
+
+   const auto sequence = mNext.fetch_add(1, ::std::memory_order_relaxed) + 1;
+   auto& payload = Begin(sequence);
+   payload.mStamp = static_cast<int64_t>(tFlightLine);
+   payload.mType = Payload::Deferred;
+   payload.mSize = static_cast<uint16_t>(size);
+   ::std::memcpy(payload.mText, &format, sizeof(format));
+   ::std::memcpy(payload.mText + sizeof(format), data, size);
+   End(sequence);
+}
+
+/// Replay the lines, that are still in the ring, into an attachment, oldest  
+/// first. Text, whose line was already overwritten, is skipped, as are       
+/// slots that are overwritten while reading them                             
+///   @param sink - the attachment to write to                                
+///   @return the number of replayed lines                                    
+size_t FlightRecorder::Replay(const A::Interface& sink) const {
+   struct Line {
+      uint64_t mSequence;
+      Payload  mHead;
+      ::std::string mText;
+   };
+
+   ::std::vector<Line> lines;
+   const auto last = mNext.load(::std::memory_order_acquire);
+   const auto slots = mMask + 1;
+   for (auto sequence = last > slots ? last - slots + 1 : 1; sequence <= last; ++sequence) {
+      auto& slot = mSlots[sequence & mMask];
+      if (slot.mSequence.load(::std::memory_order_acquire) != sequence)
+         continue;
+
+      const Payload payload = slot.mPayload;
+      ::std::atomic_thread_fence(::std::memory_order_acquire);
+      if (slot.mSequence.load(::std::memory_order_relaxed) != sequence)
+         continue;
+
+      if (payload.mType == Payload::NewLine) {
+         lines.push_back({sequence, payload, {}});
+         continue;
+      }
+
+      // Lines are in the order of their sequence                       
+      const auto line = ::std::lower_bound(lines.begin(), lines.end(),
+         static_cast<uint64_t>(payload.mStamp),
+         [](const Line& l, uint64_t s) { return l.mSequence < s; });
+      if (line == lines.end() or line->mSequence != static_cast<uint64_t>(payload.mStamp))
+         continue;
+
+      if (payload.mType == Payload::Text)
+         line->mText.append(payload.mText, ::std::min<size_t>(payload.mSize, Capacity));
+      else {
+         Formatter format;
+         ::std::memcpy(&format, payload.mText, sizeof(format));
+         ::fmt::memory_buffer formatted;
+         format(payload.mText + sizeof(format), formatted);
+         line->mText.append(formatted.data(), formatted.size());
+      }
+   }
+
+   const SavedContext saved;
+   for (auto& line : lines) {
+      // Attachments apply the style of the line's intent by themselves 
+      Record record;
+      record.type = Record::NewLine;
+      record.intent = line.mHead.mIntent < static_cast<uint8_t>(Intent::Counter)
+         ? static_cast<Intent>(line.mHead.mIntent) : Intent::Ignore;
+      record.tabs = line.mHead.mTabs;
+      record.time = TimePoint {::std::chrono::duration_cast<TimePoint::duration>(
+         ::std::chrono::nanoseconds {line.mHead.mStamp})};
+      record.style = record.intent < Intent::Counter
+         ? Instance.IntentStyle[int(record.intent)].style : Style {};
+      record.size = 0;
+      UseContext(record);
+
+      sink.NewLine();
+      if (not line.mText.empty())
+         sink.Write(TextView {line.mText});
+   }
+   return lines.size();
+}
+
+
+/// Start keeping recent history of the given intents in memory, even if they 
+/// are silenced. The ring is allocated the first time this is called, and    
+/// keeps its size until the logger is destroyed. Beware, that recorded       
+/// intents are formatted even while silenced - IsSilenced is false for them, 
+/// so their statements lose the early-out of Silence. By default only        
+/// errors and warnings are recorded, which are rarely silenced, so pass      
+/// Verbose or Flow explicitly, if their context is worth formatting them     
+///   @param bytes - the size of the ring                                     
+///   @param intents - the intents to record, errors and warnings by default  
+void Interface::StartFlightRecorder(size_t bytes, IntentMask intents) noexcept {
+   if (not mFlight.load(::std::memory_order_acquire)) {
+      try {
+         auto recorder = ::std::make_unique<FlightRecorder>(bytes);
+         FlightRecorder* expected = nullptr;
+         if (mFlight.compare_exchange_strong(expected, recorder.get()))
+            recorder.release();
+      }
+      catch (...) { return; }
+   }
+
+   mFlightIntents.store(intents.mBits, ::std::memory_order_release);
+}
+
+/// Stop recording, what was recorded can still be dumped                     
+void Interface::StopFlightRecorder() noexcept {
+   mFlightIntents.store(0, ::std::memory_order_release);
+}
+
+/// Dump the flight recorder to FlightRecorderFile when a signal is raised,   
+/// as soon as any thread finishes its current statement. Meant for signals   
+/// like SIGUSR1, that ask for a dump on demand                               
+///   @param signal - the signal to handle                                    
+void Interface::SetFlightRecorderSignal(int signal) noexcept {
+   ::std::signal(signal, [](int) {
+      gFlightSignaled.store(true, ::std::memory_order_relaxed);
+   });
+}
+
+/// Dump the flight recorder, if a fatal error was just logged by the current 
+/// thread, or if its signal was raised                                       
+void Interface::CheckFlightRecorder() const noexcept {
+   const bool fatal = ::std::exchange(tFlightFatal, false);
+   const bool signaled = gFlightSignaled.load(::std::memory_order_relaxed)
+      and gFlightSignaled.exchange(false);
+   if (not fatal and not signaled)
+      return;
+
+   Flush();
+   DumpFlightRecorder(FlightRecorderFile);
+}
+
+/// Replay the flight recorder into an attachment                             
+///   @param sink - the attachment to write to                                
+///   @return the number of replayed lines                                    
+size_t Interface::DumpFlightRecorder(const A::Interface& sink) const noexcept {
+   const auto recorder = mFlight.load(::std::memory_order_acquire);
+   if (not recorder)
+      return 0;
+
+   try { return recorder->Replay(sink); }
+   catch (...) { return 0; }
+}
+
+/// Dump the flight recorder to a binary log, that can be decoded with        
+/// DecodeBinary, or the LangulusLoggerDecode tool                            
+///   @param filename - the binary log file to create                         
+///   @return the number of dumped lines                                      
+size_t Interface::DumpFlightRecorder(const TextView& filename) const noexcept {
+   try {
+      const ToBinary sink {filename};
+      return DumpFlightRecorder(sink);
+   }
+   catch (...) { return 0; }
+}
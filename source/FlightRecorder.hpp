@@ -0,0 +1,77 @@
+///                                                                           
+/// Langulus::Logger                                                          
+/// Copyright (c) 2012 Dimo Markov <team@langulus.com>                        
+/// Part of the Langulus framework, see https://langulus.com                  
+///                                                                           
+/// SPDX-License-Identifier: MIT                                              
+///                                                                           
+#pragma once
+#include "Logger.hpp"
+
+
+namespace Langulus::Logger::Inner
+{
+
+   ///                                                                        
+   /// Fixed ring of compact records, that keeps the most recent history of   
+   /// all threads, overwriting the oldest. Writing reserves slots with a     
+   /// single atomic increment, and copies the text into them, so it is cheap 
+   /// enough to stay always on. Styles aren't kept, lines are replayed in    
+   /// the style of their intent                                              
+   ///                                                                        
+   class FlightRecorder {
+   public:
+      static constexpr size_t SlotSize = 128;
+
+      struct Payload {
+         enum Type : uint8_t {
+            Text, NewLine, Deferred
+         };
+
+         // Time of a NewLine in nanoseconds, or for Text and Deferred -
+         // the sequence of the NewLine slot they belong to             
+         int64_t  mStamp;
+         Type     mType;
+         uint8_t  mIntent;
+         uint16_t mSize;
+         uint32_t mTabs;
+         // Text, or for Deferred - the formatter, followed by the bytes
+         Letter   mText[SlotSize - 24];
+      };
+
+      static constexpr size_t Capacity = sizeof(Payload::mText);
+
+   private:
+      struct Slot {
+         // Sequence of the payload, zero while it is being written     
+         ::std::atomic<uint64_t> mSequence {};
+         Payload mPayload;
+      };
+
+      static_assert(sizeof(Slot) == SlotSize, "Slots must stay compact");
+      static_assert(sizeof(Formatter) + MaxDeferredSize <= Capacity,
+         "Deferred values must fit in a single slot");
+
+      ::std::unique_ptr<Slot[]> mSlots;
+      size_t mMask;
+      ::std::atomic<uint64_t> mNext {};
+
+      Payload& Begin(uint64_t) noexcept;
+      void End(uint64_t) noexcept;
+
+   public:
+      explicit FlightRecorder(size_t bytes);
+
+      NOD() size_t GetSize() const noexcept {
+         return (mMask + 1) * SlotSize;
+      }
+
+      static void MarkFatal() noexcept;
+
+      void NewLine(Intent, uint32_t tabs, TimePoint) noexcept;
+      void Write(const TextView&) noexcept;
+      void WriteDeferred(Formatter, const void*, size_t) noexcept;
+      size_t Replay(const A::Interface&) const;
+   };
+
+} // namespace Langulus::Logger::Inner
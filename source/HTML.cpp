@@ -5,188 +5,207 @@
 ///                                                                           
 /// SPDX-License-Identifier: MIT                                              
 ///                                                                           
-#include "Logger.hpp"
+#include "FileWriter.hpp"
 
 using namespace Langulus;
 using namespace Langulus::Logger;
 
+/// Get the index of a terminal color in the stylesheet                       
+///   @param color - the terminal color                                       
+///   @return an index in the range [0; 16)                                   
+constexpr uint8_t ColorIndex(uint8_t color) noexcept {
+   return color >= 90 ? (color - 90 + 8) & 15 : (color - 30) & 15;
+}
+
+/// Names of the terminal colors, in the order of ColorIndex                  
+constexpr TextView ColorNames[16] {
+   "black", "DarkRed", "ForestGreen", "DarkOrange",
+   "blue", "DarkMagenta", "DarkCyan", "LightGray",
+   "gray", "Red", "GreenYellow", "Gold",
+   "royalblue", "magenta", "cyan", "white"
+};
+
+/// Class names for foreground and background terminal colors                 
+constexpr TextView ForegroundClasses[16] {
+   "f0", "f1", "f2", "f3", "f4", "f5", "f6", "f7",
+   "f8", "f9", "fa", "fb", "fc", "fd", "fe", "ff"
+};
+
+constexpr TextView BackgroundClasses[16] {
+   "b0", "b1", "b2", "b3", "b4", "b5", "b6", "b7",
+   "b8", "b9", "ba", "bb", "bc", "bd", "be", "bf"
+};
+
+/// Class names for emphasis flags, in the order of fmt::emphasis bits        
+constexpr TextView EmphasisClasses[8] {
+   "eb", "ef", "ei", "eu", "ek", "er", "ec", "es"
+};
+
+/// Check if two styles have the same foreground or background color          
+///   @param a - the first style                                              
+///   @param b - the second style                                             
+///   @param foreground - whether to compare foreground or background         
+///   @return true if colors are the same, or both are missing                
+bool SameColor(const Style& a, const Style& b, bool foreground) noexcept {
+   const bool hasA = foreground ? a.has_foreground() : a.has_background();
+   const bool hasB = foreground ? b.has_foreground() : b.has_background();
+   if (hasA != hasB)
+      return false;
+   if (not hasA)
+      return true;
+
+   const auto ca = foreground ? a.get_foreground() : a.get_background();
+   const auto cb = foreground ? b.get_foreground() : b.get_background();
+   if (ca.is_rgb != cb.is_rgb)
+      return false;
+   return ca.is_rgb
+      ? ca.value.rgb_color  == cb.value.rgb_color
+      : ca.value.term_color == cb.value.term_color;
+}
+
+/// Get the emphasis flags of a style                                         
+uint8_t GetEmphasis(const Style& style) noexcept {
+   return style.has_emphasis()
+      ? static_cast<uint8_t>(style.get_emphasis()) : uint8_t {0};
+}
+
+/// Check if two styles would generate the same markup                        
+bool SameStyle(const Style& a, const Style& b) noexcept {
+   return GetEmphasis(a) == GetEmphasis(b)
+      and SameColor(a, b, true)
+      and SameColor(a, b, false);
+}
+
 
 /// Create an HTML file duplicator/redirector                                 
 ///   @param filename - the relative filename of the log file                 
-ToHTML::ToHTML(const TextView& filename) : mFilename {filename} {
-   mFile.open(mFilename, std::ios::out | std::ios::trunc);
-   if (not mFile)
-      throw std::runtime_error {"Can't open log file"};
+///   @param policy - buffering, flushing and syncing policy                  
+ToHTML::ToHTML(const TextView& filename, const FilePolicy& policy)
+   : mFile {::std::make_unique<Inner::FileWriter>(filename, policy)} {
    WriteHeader();
+
+   // A stray closing tag is harmless, if no span is open on a crash    
+   mFile->SetEmergencyFooter("</span></code><h2>Log ended abruptly</h2></body></html>");
 }
 
 ToHTML::~ToHTML() {
    WriteFooter();
-   mFile.close();
 }
 
 /// Write text                                                                
 ///   @param text - the text to append to the file                            
 void ToHTML::Write(const TextView& text) const noexcept {
-   mFile << text;
-   mFile.flush();
+   if (text.empty())
+      return;
+
+   // Styles are applied lazily, so that consecutive style changes      
+   // don't produce empty spans                                         
+   if (mStyleOpen ? not SameStyle(mStyle, mOpenStyle) : mStylePending)
+      OpenStyle();
+
+   mFile->Write(text);
+   mFile->Commit(false);
 }
 
-/// Apply some style                                                          
+/// Apply some style - the span is opened with the next written text, and     
+/// only if the style differs from the one that is already open               
 ///   @param style - the style to set                                         
 void ToHTML::Write(Style style) const noexcept {
-   // Always reset before a style change                                
-   Write("\n</code></strong></em></u></blink></del></span><code>");
-
-   if (style.has_emphasis()) {
-      const auto em = static_cast<uint8_t>(style.get_emphasis());
-      if (em & static_cast<uint8_t>(fmt::emphasis::bold))
-         Write("<strong>");
-      //if (em & static_cast<uint8_t>(fmt::emphasis::faint))
-      //   ;
-      if (em & static_cast<uint8_t>(fmt::emphasis::italic))
-         Write("<em>");
-      if (em & static_cast<uint8_t>(fmt::emphasis::underline))
-         Write("<u>");
-      if (em & static_cast<uint8_t>(fmt::emphasis::blink))
-         Write("<blink>");
-      //if (em & static_cast<uint8_t>(fmt::emphasis::reverse))
-      //   ;
-      //if (em & static_cast<uint8_t>(fmt::emphasis::conceal))
-      //   ;
-      if (em & static_cast<uint8_t>(fmt::emphasis::strikethrough))
-         Write("<del>");
-   }
+   mStyle = style;
+   mStylePending = GetEmphasis(style)
+      or style.has_foreground()
+      or style.has_background();
+}
 
-   if (not style.has_foreground() and not style.has_background())
+/// Close the last span, and open one with the current style, using classes   
+/// from the stylesheet                                                       
+void ToHTML::OpenStyle() const noexcept {
+   CloseStyle();
+   mOpenStyle = mStyle;
+   if (not mStylePending)
       return;
 
-   std::string style_string = "<span style = \"";
-   if (style.has_foreground()) {
-      const auto fg = static_cast<fmt::terminal_color>(
-         style.get_foreground().value.term_color);
-
-      switch (fg) {
-      case fmt::terminal_color::black:
-         style_string += "color: black; ";
-         break;
-      case fmt::terminal_color::red:
-         style_string += "color: DarkRed; ";
-         break;
-      case fmt::terminal_color::green:
-         style_string += "color: ForestGreen; ";
-         break;
-      case fmt::terminal_color::yellow:
-         style_string += "color: DarkOrange; ";
-         break;
-      case fmt::terminal_color::blue:
-         style_string += "color: blue; ";
-         break;
-      case fmt::terminal_color::magenta:
-         style_string += "color: DarkMagenta; ";
-         break;
-      case fmt::terminal_color::cyan:
-         style_string += "color: DarkCyan; ";
-         break;
-      case fmt::terminal_color::white:
-         style_string += "color: LightGray; ";
-         break;
-      case fmt::terminal_color::bright_black:
-         style_string += "color: gray; ";
-         break;
-      case fmt::terminal_color::bright_red:
-         style_string += "color: Red; ";
-         break;
-      case fmt::terminal_color::bright_green:
-         style_string += "color: GreenYellow; ";
-         break;
-      case fmt::terminal_color::bright_yellow:
-         style_string += "color: Gold; ";
-         break;
-      case fmt::terminal_color::bright_blue:
-         style_string += "color: royalblue; ";
-         break;
-      case fmt::terminal_color::bright_magenta:
-         style_string += "color: magenta; ";
-         break;
-      case fmt::terminal_color::bright_cyan:
-         style_string += "color: cyan; ";
-         break;
-      case fmt::terminal_color::bright_white:
-         style_string += "color: white; ";
-         break;
-      }
+   // Terminal colors and emphasis use classes, while RGB colors, which 
+   // are rare, are written inline                                      
+   const auto& style = mStyle;
+   const auto em = GetEmphasis(style);
+   fmt::basic_memory_buffer<Letter, 128> markup;
+   auto out = ::std::back_inserter(markup);
+   fmt::format_to(out, "<span class=\"");
+   bool first = true;
+   const auto separator = [&] {
+      if (not first)
+         markup.push_back(' ');
+      first = false;
+   };
+
+   if (style.has_foreground() and not style.get_foreground().is_rgb) {
+      const auto fg = style.get_foreground().value.term_color;
+      separator();
+      markup.append(ForegroundClasses[ColorIndex(fg)]);
+   }
+
+   if (style.has_background() and not style.get_background().is_rgb) {
+      const auto bg = style.get_background().value.term_color;
+      separator();
+      markup.append(BackgroundClasses[ColorIndex(bg)]);
    }
-   
-   if (style.has_background()) {
-      const auto bg = static_cast<fmt::terminal_color>(
-         style.get_background().value.term_color);
-
-      switch (bg) {
-      case fmt::terminal_color::black:
-         style_string += "background-color: black; ";
-         break;
-      case fmt::terminal_color::red:
-         style_string += "background-color: DarkRed; ";
-         break;
-      case fmt::terminal_color::green:
-         style_string += "background-color: ForestGreen; ";
-         break;
-      case fmt::terminal_color::yellow:
-         style_string += "background-color: DarkOrange; ";
-         break;
-      case fmt::terminal_color::blue:
-         style_string += "background-color: blue; ";
-         break;
-      case fmt::terminal_color::magenta:
-         style_string += "background-color: DarkMagenta; ";
-         break;
-      case fmt::terminal_color::cyan:
-         style_string += "background-color: DarkCyan; ";
-         break;
-      case fmt::terminal_color::white:
-         style_string += "background-color: LightGray; ";
-         break;
-      case fmt::terminal_color::bright_black:
-         style_string += "background-color: gray; ";
-         break;
-      case fmt::terminal_color::bright_red:
-         style_string += "background-color: Red; ";
-         break;
-      case fmt::terminal_color::bright_green:
-         style_string += "background-color: GreenYellow; ";
-         break;
-      case fmt::terminal_color::bright_yellow:
-         style_string += "background-color: Gold; ";
-         break;
-      case fmt::terminal_color::bright_blue:
-         style_string += "background-color: royalblue; ";
-         break;
-      case fmt::terminal_color::bright_magenta:
-         style_string += "background-color: magenta; ";
-         break;
-      case fmt::terminal_color::bright_cyan:
-         style_string += "background-color: cyan; ";
-         break;
-      case fmt::terminal_color::bright_white:
-         style_string += "background-color: white; ";
-         break;
+
+   for (int i = 0; i < 8; ++i) {
+      if (em & (1 << i)) {
+         separator();
+         markup.append(EmphasisClasses[i]);
       }
    }
 
-   style_string += "\">\n";
-   Write(style_string);
+   markup.push_back('"');
+
+   const bool fgRGB = style.has_foreground() and style.get_foreground().is_rgb;
+   const bool bgRGB = style.has_background() and style.get_background().is_rgb;
+   if (fgRGB or bgRGB) {
+      markup.append(TextView {" style=\""});
+      if (fgRGB)
+         fmt::format_to(out, "color:#{:06x};", style.get_foreground().value.rgb_color);
+      if (bgRGB)
+         fmt::format_to(out, "background-color:#{:06x};", style.get_background().value.rgb_color);
+      markup.push_back('"');
+   }
+
+   markup.push_back('>');
+   mFile->Write(TextView {markup.data(), markup.size()});
+   mStyleOpen = true;
+}
+
+/// Close the span of the last style, if any                                  
+void ToHTML::CloseStyle() const noexcept {
+   if (not mStyleOpen)
+      return;
+
+   mFile->Write("</span>");
+   mStyleOpen = false;
 }
 
 /// Remove formatting, add a new line, add a timestamp and tabulate           
 ///   @attention top of the style stack is not applied                        
 void ToHTML::NewLine() const noexcept {
-   Write("<br>");
+   // The previous line ends here                                       
+   mFile->Commit(true);
+
+   if (mFile->IsRotationDue()) {
+      // Each file is a complete log, with its own header and footer    
+      WriteFooter();
+      mFile->Rotate();
+      WriteHeader();
+   }
+
+   mFile->BeginLine(Instance.GetIntent());
+
+   mFile->Write("<br>");
    Write(Instance.TimeStampStyle);
-   Write(GetSimpleTime());
+   Write(GetSimpleTimeView(Instance.GetLineTime()));
    Write("|");
-   if (Instance.CurrentIntent != Intent::Ignore)
-      Write(Instance.IntentStyle[int(Instance.CurrentIntent)].prefix);
+   if (Instance.GetIntent() != Intent::Ignore)
+      Write(Instance.IntentStyle[int(Instance.GetIntent())].prefix);
    else
       Write(" ");
    Write("| ");
@@ -205,23 +224,43 @@ void ToHTML::NewLine() const noexcept {
 
 /// Clear the log file                                                        
 void ToHTML::Clear() const noexcept {
-   mFile.close();
-   mFile.open(mFilename, std::ios::out | std::ios::trunc);
+   mFile->Truncate();
+   mStyleOpen = mStylePending = false;
    WriteHeader();
 }
 
-/// Write file header - general HTML styling options, etc.                    
+/// Write anything that is buffered to the file                               
+void ToHTML::Flush() const noexcept {
+   mFile->Flush();
+}
+
+/// Write file header - general HTML styling options, and a stylesheet with   
+/// a class for each terminal color and emphasis                              
 void ToHTML::WriteHeader() const {
-   Write("<!DOCTYPE html><html>\n");
-   Write("<body style = \"color: LightGray; background-color: black; font-family: monospace; font-size: 14px;\">\n");
-   Write("<h2>Log started - ");
-   Write(GetAdvancedTime());
-   Write("</h2><code>\n");
+   mFile->Write("<!DOCTYPE html><html>\n<head><style>\n");
+   mFile->Write("body{color:LightGray;background-color:black;font-family:monospace;font-size:14px;}\n");
+
+   fmt::basic_memory_buffer<Letter, 1024> sheet;
+   for (int i = 0; i < 16; ++i) {
+      fmt::format_to(::std::back_inserter(sheet), ".{}{{color:{};}}.{}{{background-color:{};}}\n",
+         ForegroundClasses[i], ColorNames[i], BackgroundClasses[i], ColorNames[i]);
+   }
+   mFile->Write(TextView {sheet.data(), sheet.size()});
+
+   mFile->Write(".eb{font-weight:bold;}.ef{opacity:0.6;}.ei{font-style:italic;}");
+   mFile->Write(".eu{text-decoration:underline;}.es{text-decoration:line-through;}");
+   mFile->Write(".eu.es{text-decoration:underline line-through;}.ec{visibility:hidden;}");
+   mFile->Write(".ek{animation:blink 1s step-end infinite;}@keyframes blink{50%{opacity:0;}}");
+   mFile->Write(".er{filter:invert(1);}\n");
+   mFile->Write("</style></head>\n<body>\n<h2>Log started - ");
+   mFile->Write(GetAdvancedTimeView());
+   mFile->Write("</h2><code>\n");
 }
 
 /// Write file footer - just the official shutdown timestamp                  
 void ToHTML::WriteFooter() const {
-   Write("</strong></em></u></blink></del></span><h2>Log ended - ");
-   Write(GetAdvancedTime());
-   Write("</h2></code></body></html>");
+   CloseStyle();
+   mFile->Write("</code><h2>Log ended - ");
+   mFile->Write(GetAdvancedTimeView());
+   mFile->Write("</h2></body></html>");
 }
@@ -5,14 +5,29 @@
 ///                                                                           
 /// SPDX-License-Identifier: MIT                                              
 ///                                                                           
-#include "Logger.hpp"
+#include "Async.hpp"
+#include "Records.hpp"
+#include "FlightRecorder.hpp"
+#include "Escape.hpp"
 #include <type_traits>
 #include <syncstream>
+#include <stack>
 #include <chrono>
+#include <limits>
+#include <array>
+#include <cstring>
 #include <fmt/chrono.h>
+#include <cerrno>
+#include <mutex>
+#include <span>
+#include <vector>
 
+#ifdef _WIN32
+   #include <io.h>
+#else
+   #include <unistd.h>
+#endif
 
-using Clock = ::std::chrono::system_clock;
 
 namespace Langulus::Logger
 {
@@ -20,50 +35,534 @@ namespace Langulus::Logger
    Interface   Instance {};
    MessageSink MessageSinkInstance {};
 
-   void AttachDuplicator(A::Interface* d) noexcept {
-      Instance.AttachDuplicator(d);
+   void AttachDuplicator(A::Interface* d, IntentMask m) noexcept {
+      Instance.AttachDuplicator(d, m);
    }
 
    void DettachDuplicator(A::Interface* d) noexcept {
       Instance.DettachDuplicator(d);
    }
 
-   void AttachRedirector(A::Interface* r) noexcept {
-      Instance.AttachRedirector(r);
+   void AttachRedirector(A::Interface* r, IntentMask m) noexcept {
+      Instance.AttachRedirector(r, m);
    }
 
    void DettachRedirector(A::Interface* r) noexcept {
       Instance.DettachRedirector(r);
    }
 
+   void SetAsync(bool enable) noexcept {
+      Instance.SetAsync(enable);
+   }
+
+   void Flush() noexcept {
+      Instance.Flush();
+   }
+
+   void Silence(Intent i) noexcept {
+      Instance.Silence(i);
+   }
+
+   void Unsilence(Intent i) noexcept {
+      Instance.Unsilence(i);
+   }
+
+   void StartFlightRecorder(size_t bytes, IntentMask m) noexcept {
+      Instance.StartFlightRecorder(bytes, m);
+   }
+
+   size_t DumpFlightRecorder(const TextView& filename) noexcept {
+      return Instance.DumpFlightRecorder(filename);
+   }
+
+   /// Every registered call site, most recent first                          
+   ::std::atomic<CallSite*> gCallSites {};
+
+   /// A call to EnableCallSites, that is remembered for the call sites,      
+   /// that aren't registered yet, like those of modules loaded later         
+   struct CallSiteRule {
+      ::std::string mFile;
+      uint32_t mLine;
+      bool mEnable;
+
+      NOD() bool Matches(const CallSite& site) const noexcept {
+         return site.file.ends_with(mFile) and (not mLine or site.line == mLine);
+      }
+   };
+
+   /// The rules in the order they were made, later ones take precedence      
+   struct CallSiteRules {
+      ::std::mutex mMutex;
+      ::std::vector<CallSiteRule> mRules;
+   } gCallSiteRules;
+
+   /// Every throttled call site, that has skipped statements, most recent    
+   /// first                                                                  
+   ::std::atomic<Throttle*> gThrottles {};
+
+   /// Add a throttled call site to the registry, so that Flush reports its   
+   /// skipped statements. Done the first time it skips a statement           
+   void Throttle::Register() noexcept {
+      mNext = gThrottles.load(::std::memory_order_relaxed);
+      while (not gThrottles.compare_exchange_weak(mNext, this,
+         ::std::memory_order_release, ::std::memory_order_relaxed));
+   }
+
+   /// Log a line for each throttled call site, that skipped statements since 
+   /// its last statement that passed, unless its intent is silenced          
+   void Throttle::ReportSkipped() noexcept {
+      auto site = gThrottles.load(::std::memory_order_acquire);
+      if (not site)
+         return;
+
+      // The thread's statement continues after the flush               
+      const Inner::SavedContext saved;
+      for (; site; site = site->mNext) {
+         if (Instance.IsSilenced(site->intent)
+         or site->mSkipped.load(::std::memory_order_relaxed) == 0)
+            continue;
+
+         const auto skipped = site->TakeSkipped();
+         if (not skipped)
+            continue;
+
+         auto file = site->file;
+         if (const auto slash = file.find_last_of("/\\"); slash != TextView::npos)
+            file.remove_prefix(slash + 1);
+
+         const ScopedBatch batch;
+         Instance << site->intent;
+         Instance.NewLine();
+         Instance << file << ':' << site->line << " skipped " << skipped << " more";
+      }
+   }
+
+   /// Describe a call site, switch it by the rules made by EnableCallSites   
+   /// so far, and add it to the registry                                     
+   ///   @param file - the source file of the call site                       
+   ///   @param line - the line in the source file                            
+   ///   @param function - the function that contains the call site           
+   ///   @param intent - the intent of the logged statement                   
+   ///   @param format - the arguments of the statement, as written           
+   CallSite::CallSite(
+      const TextView& file, uint32_t line, const TextView& function,
+      Intent intent, const TextView& format
+   ) noexcept
+      : file {file}
+      , line {line}
+      , function {function}
+      , intent {intent}
+      , format {format} {
+      const ::std::scoped_lock lock {gCallSiteRules.mMutex};
+      for (auto& rule : gCallSiteRules.mRules) {
+         if (rule.Matches(*this))
+            Enable(rule.mEnable);
+      }
+
+      mNext = gCallSites.load(::std::memory_order_relaxed);
+      while (not gCallSites.compare_exchange_weak(mNext, this,
+         ::std::memory_order_release, ::std::memory_order_relaxed));
+   }
+
+   /// Get the call site that was registered last, use Next() for the rest    
+   ///   @return the first call site, or nullptr if none was registered       
+   CallSite* CallSite::First() noexcept {
+      return gCallSites.load(::std::memory_order_acquire);
+   }
+
+   /// Switch call sites on or off by their location. The rule is kept, and   
+   /// also applied to the call sites, that are registered later              
+   ///   @param enable - whether the call sites should log                    
+   ///   @param file - the end of the source file's path, like "Network.cpp"  
+   ///   @param line - the line of the call site, or 0 for the whole file     
+   ///   @return the number of registered call sites, that were switched      
+   size_t EnableCallSites(bool enable, const TextView& file, uint32_t line) noexcept {
+      // Call sites that are being registered meanwhile wait for it     
+      const ::std::scoped_lock lock {gCallSiteRules.mMutex};
+      try {
+         auto& rules = gCallSiteRules.mRules;
+         ::std::erase_if(rules, [&](const CallSiteRule& rule) {
+            return rule.mFile == file and rule.mLine == line;
+         });
+         rules.push_back({::std::string {file}, line, enable});
+      }
+      catch (...) {}
+
+      size_t switched = 0;
+      for (auto site = CallSite::First(); site; site = site->Next()) {
+         if (not site->file.ends_with(file) or (line and site->line != line))
+            continue;
+
+         site->Enable(enable);
+         ++switched;
+      }
+      return switched;
+   }
+
 } // namespace Langulus::Logger
 
 using namespace Langulus;
 using namespace Langulus::Logger;
 
+/// Logger state, that is unique for each thread, so that threads can log in  
+/// parallel, without corrupting each other's styles, tabs and intents        
+struct Context {
+   // Color stack                                                       
+   ::std::stack<Style> mStyleStack;
+   // Number of tabulations                                             
+   size_t mTabulator = 0;
+   // Current intent                                                    
+   Intent mIntent = Intent::Info;
+   // When the current line was started                                 
+   TimePoint mLineTime;
+   // Whether the current intent is silenced, and only recorded         
+   bool mMuted = false;
+};
+
+thread_local Context tContext;
+
+/// Lines, that the current thread assembles for record sinks, and whether    
+/// the last statement in them was dispatched whole                           
+thread_local Inner::Lines tLines;
+thread_local bool tLinesWhole = true;
+
+/// Attaching and dettaching is serialized, but never blocks dispatching      
+::std::mutex gAttachmentsMutex;
+
+/// Immutable snapshot of a logger's attachments. Each change makes a new     
+/// copy, so dispatching is a lock-free scan over contiguous arrays           
+struct Inner::Attachments {
+   struct Attachment {
+      A::Interface* mSink;
+      IntentMask mMask;
+      // Set if the attachment receives whole records                   
+      const A::RecordSink* mRecords;
+   };
+
+   using Sinks = ::std::vector<A::Interface*>;
+   using SinksOf = ::std::array<Sinks, int(Intent::Counter)>;
+
+   // Attachments in the order they were attached, with their masks     
+   ::std::vector<Attachment> mRedirectors;
+   ::std::vector<Attachment> mDuplicators;
+
+   // The attachments that receive each intent fragment by fragment,    
+   // so that dispatching never even looks at the ones that don't       
+   SinksOf mRedirectorsOf;
+   SinksOf mDuplicatorsOf;
+
+   // Intents, that are consumed by a redirector, and intents, that are 
+   // received by a record sink, one bit for each                       
+   uint32_t mRedirected = 0;
+   uint32_t mRecorded = 0;
+
+   /// Sort the attachments by the intents they receive                       
+   void Index() {
+      mRedirected = mRecorded = 0;
+      for (auto& attachment : mRedirectors) {
+         mRedirected |= attachment.mMask.mBits;
+         if (attachment.mRecords)
+            mRecorded |= attachment.mMask.mBits;
+      }
+      for (auto& attachment : mDuplicators) {
+         if (attachment.mRecords)
+            mRecorded |= attachment.mMask.mBits;
+      }
+
+      for (int i = 0; i < int(Intent::Counter); ++i) {
+         mRedirectorsOf[i].clear();
+         for (auto& attachment : mRedirectors) {
+            if (not attachment.mRecords and attachment.mMask.Contains(Intent(i)))
+               mRedirectorsOf[i].push_back(attachment.mSink);
+         }
+
+         mDuplicatorsOf[i].clear();
+         for (auto& attachment : mDuplicators) {
+            if (not attachment.mRecords and attachment.mMask.Contains(Intent(i)))
+               mDuplicatorsOf[i].push_back(attachment.mSink);
+         }
+      }
+   }
+};
+
+/// Pins the current snapshot of attachments, for the duration of a           
+/// dispatch. Readers never wait - they only count themselves in the          
+/// generation they started in, so that writers can wait for them             
+struct Interface::Reading {
+   const Interface& mLogger;
+   size_t mGeneration;
+   const Inner::Attachments* mAttachments;
+
+   Reading(const Interface& logger) noexcept
+      : mLogger {logger} {
+      // If the generation changed while we were counting ourselves in, 
+      // the writer might have missed us, so count again                
+      while (true) {
+         mGeneration = mLogger.mGeneration.load();
+         mLogger.mReaders[mGeneration & 1].fetch_add(1);
+         if (mGeneration == mLogger.mGeneration.load())
+            break;
+         mLogger.mReaders[mGeneration & 1].fetch_sub(1);
+      }
+
+      mAttachments = mLogger.mAttachments.load();
+   }
+
+   ~Reading() {
+      mLogger.mReaders[mGeneration & 1].fetch_sub(1);
+   }
+
+   /// Get all redirectors, regardless of the intents they receive            
+   auto Redirectors() const noexcept -> ::std::span<const Inner::Attachments::Attachment> {
+      if (not mAttachments)
+         return {};
+      return mAttachments->mRedirectors;
+   }
+
+   /// Get all duplicators, regardless of the intents they receive            
+   auto Duplicators() const noexcept -> ::std::span<const Inner::Attachments::Attachment> {
+      if (not mAttachments)
+         return {};
+      return mAttachments->mDuplicators;
+   }
+
+   /// Check if a redirector consumes an intent, so that it doesn't reach     
+   /// the console and duplicators                                            
+   bool IsRedirected(Intent i) const noexcept {
+      return mAttachments and IntentMask {i}.mBits & mAttachments->mRedirected;
+   }
+
+   /// Check if any record sink receives an intent                            
+   bool IsRecorded(Intent i) const noexcept {
+      return mAttachments and IntentMask {i}.mBits & mAttachments->mRecorded;
+   }
+
+   /// Give each record sink the records it receives, in as few calls as      
+   /// possible - consecutive records it receives go in a single call         
+   ///   @param records - the records to deliver                              
+   void Deliver(::std::span<const LogRecord> records) const noexcept {
+      const auto deliver = [&](const Inner::Attachments::Attachment& to, bool redirector) {
+         size_t first = 0;
+         for (size_t i = 0; i <= records.size(); ++i) {
+            if (i < records.size() and to.mMask.Contains(records[i].intent)
+            and (redirector or not IsRedirected(records[i].intent)))
+               continue;
+
+            if (i > first)
+               to.mRecords->WriteRecords(records.subspan(first, i - first));
+            first = i + 1;
+         }
+      };
+
+      for (auto& attachment : Redirectors()) {
+         if (attachment.mRecords)
+            deliver(attachment, true);
+      }
+      for (auto& attachment : Duplicators()) {
+         if (attachment.mRecords)
+            deliver(attachment, false);
+      }
+   }
+
+   /// Get the redirectors, that receive an intent                            
+   auto Redirectors(Intent i) const noexcept -> ::std::span<A::Interface* const> {
+      if (not mAttachments or i >= Intent::Counter)
+         return {};
+      return mAttachments->mRedirectorsOf[int(i)];
+   }
+
+   /// Get the duplicators, that receive an intent                            
+   auto Duplicators(Intent i) const noexcept -> ::std::span<A::Interface* const> {
+      if (not mAttachments or i >= Intent::Counter)
+         return {};
+      return mAttachments->mDuplicatorsOf[int(i)];
+   }
+};
+
    
-/// When using fmt::print(style, mask, ...), the style will be reset after    
-/// message has been written, and I don't want that to happen                 
-///   @param style - the style to set                                         
-LANGULUS(INLINED)
-void FmtPrintStyle(const Style& style) {
-   // Always reset before a style change                                
-   fmt::print("{}", "\x1b[0m");
-      
-   if (style.has_emphasis()) {
-      const auto e = fmt::detail::make_emphasis<Letter>(style.get_emphasis());
-      fmt::print("{}", e.begin());
+/// Write text to a console stream with a single call                         
+///   @param stream - the stream to write to                                  
+///   @param text - the text to write                                         
+void ConsoleWrite(::std::FILE* stream, const TextView& text) noexcept {
+#ifdef _WIN32
+   // Console output goes through fmt, so that unicode is handled       
+   try { fmt::print(stream, "{}", text); }
+   catch (...) {}
+   fflush(stream);
+#else
+   // Anything that was printed through stdio must come before          
+   fflush(stream);
+
+   const int fd = fileno(stream);
+   auto data = text.data();
+   auto size = text.size();
+   while (size) {
+      const auto written = ::write(fd, data, size);
+      if (written < 0) {
+         if (errno == EINTR)
+            continue;
+         break;
+      }
+
+      data += written;
+      size -= static_cast<size_t>(written);
+   }
+#endif
+}
+
+/// Console output, that was handed over by all threads, and is waiting for   
+/// the flush policy. Whole lines are appended under a lock, so that lines    
+/// of different threads never interleave                                     
+struct SharedConsole {
+   ::std::mutex mMutex;
+   fmt::memory_buffer mBuffer;
+   // The stream, that the buffer will be written to                    
+   ::std::FILE* mStream = stdout;
+   // Number of buffered bytes, for checking the policy without a lock  
+   ::std::atomic<size_t> mPending {0};
+   // When the buffer was last written, in steady clock ticks           
+   ::std::atomic<int64_t> mLastCommit {0};
+   // Logging in other destructors might happen after this one is       
+   // destroyed, so don't buffer anymore                                
+   bool mAlive = true;
+
+   ~SharedConsole() {
+      const ::std::scoped_lock lock {mMutex};
+      Commit();
+      mAlive = false;
+   }
+
+   /// Append text, that will be written to a stream - lock mMutex first      
+   ///   @param stream - the stream to write to                               
+   ///   @param text - the text to append                                     
+   void Append(::std::FILE* stream, const TextView& text) {
+      if (stream != mStream) {
+         // Keep the order of messages, when switching streams          
+         Commit();
+         mStream = stream;
+      }
+
+      mBuffer.append(text.data(), text.data() + text.size());
+      mPending.store(mBuffer.size(), ::std::memory_order_relaxed);
+   }
+
+   /// Write everything buffered with a single call - lock mMutex first       
+   void Commit() noexcept {
+      mLastCommit.store(::std::chrono::steady_clock::now().time_since_epoch().count(),
+         ::std::memory_order_relaxed);
+      if (mBuffer.size() == 0)
+         return;
+
+      ConsoleWrite(mStream, {mBuffer.data(), mBuffer.size()});
+      mBuffer.clear();
+      mPending.store(0, ::std::memory_order_relaxed);
    }
+};
+
+/// Get the shared console. The logger's constructor creates it, so that it   
+/// is destroyed after the logger, which might still write to it              
+///   @return the shared console                                              
+SharedConsole& GetSharedConsole() noexcept {
+   static SharedConsole console;
+   return console;
+}
+
+struct ConsoleBuffer;
+
+/// The current thread's console buffer, once it is created. Trivial, so that 
+/// reading it from a signal handler never creates anything                   
+thread_local ConsoleBuffer* tConsoleBuffer = nullptr;
 
-   if (style.has_foreground()) {
-      const auto f = fmt::detail::make_foreground_color<Letter>(style.get_foreground());
-      fmt::print("{}", f.begin());
+/// Console output, that is assembled by the current thread, until it is      
+/// handed over to the shared console as whole lines                          
+struct ConsoleBuffer {
+   fmt::memory_buffer mBuffer;
+   // The stream, that the buffer will be written to                    
+   ::std::FILE* mStream = stdout;
+   // Thread-local objects might be used after being destroyed, while   
+   // logging in other destructors, so don't buffer anymore             
+   bool mAlive = true;
+
+   ConsoleBuffer() noexcept {
+      tConsoleBuffer = this;
    }
 
-   if (style.has_background()) {
-      const auto b = fmt::detail::make_background_color<Letter>(style.get_background());
-      fmt::print("{}", b.begin());
+   ~ConsoleBuffer() {
+      tConsoleBuffer = nullptr;
+      HandOver(true);
+      mAlive = false;
    }
+
+   /// Append text, that will be written to a stream                          
+   ///   @param stream - the stream to write to                               
+   ///   @param text - the text to append                                     
+   void Append(::std::FILE* stream, const TextView& text) {
+      if (not mAlive) {
+         ConsoleWrite(stream, text);
+         return;
+      }
+
+      if (stream != mStream) {
+         // Keep the order of messages, when switching streams          
+         HandOver(false);
+         mStream = stream;
+      }
+
+      mBuffer.append(text.data(), text.data() + text.size());
+   }
+
+   /// Move the assembled output to the shared console                        
+   ///   @param commit - whether to also write the shared console             
+   void HandOver(bool commit) noexcept {
+      auto& shared = GetSharedConsole();
+      if (not shared.mAlive) {
+         if (mBuffer.size())
+            ConsoleWrite(mStream, {mBuffer.data(), mBuffer.size()});
+         mBuffer.clear();
+         return;
+      }
+
+      const ::std::scoped_lock lock {shared.mMutex};
+      if (mBuffer.size()) {
+         try { shared.Append(mStream, {mBuffer.data(), mBuffer.size()}); }
+         catch (...) {
+            shared.Commit();
+            ConsoleWrite(mStream, {mBuffer.data(), mBuffer.size()});
+         }
+         mBuffer.clear();
+      }
+
+      if (commit)
+         shared.Commit();
+   }
+};
+
+thread_local ConsoleBuffer tConsole;
+
+/// Check if intent is an error, that should get special flushing treatment   
+///   @param intent - the intent to check                                     
+///   @return true if intent is Error or FatalError                           
+LANGULUS(INLINED)
+bool IsError(Intent intent) noexcept {
+   return intent == Intent::Error or intent == Intent::FatalError;
+}
+
+/// Pick the stream for the console output of the current thread's line       
+///   @param policy - the flush policy                                        
+///   @return stderr for errors, if policy says so, stdout otherwise          
+LANGULUS(INLINED)
+::std::FILE* GetConsole(const FlushPolicy& policy) noexcept {
+   return policy.errorsToStderr and IsError(tContext.mIntent)
+      ? stderr : stdout;
+}
+
+/// When using fmt::print(style, mask, ...), the style will be reset after    
+/// message has been written, and I don't want that to happen                 
+///   @param stream - the stream to write to                                  
+///   @param style - the style to set                                         
+LANGULUS(INLINED)
+void FmtPrintStyle(::std::FILE* stream, const Style& style) {
+   tConsole.Append(stream, Inner::Escape {style}.View());
 }
 
 /// Scoped tabulator destruction                                              
@@ -74,147 +573,756 @@ ScopedTabs::~ScopedTabs() noexcept {
    }
 }
 
-/// Logger construction                                                       
-Interface::Interface() {}
+/// Logger construction - creates the shared state, that the destructor       
+/// writes, so that it is destroyed after the logger, whatever the order of   
+/// static destruction in different translation units                         
+Interface::Interface() {
+   GetSharedConsole();
+   Inner::GetRepeats();
+}
 
 /// Logger copy-construction                                                  
-Interface::Interface(const Interface& other)
-   : mStyleStack {other.mStyleStack} {}
+Interface::Interface(const Interface&)
+   : Interface {} {}
+
+/// Logger destruction - writes anything that is still in the async queue     
+Interface::~Interface() {
+   // Repeats, that are held back, are written by the thread that       
+   // repeated them, when it ends. The state of the destroying thread   
+   // might already be gone, so only a running worker writes the ones   
+   // of threads, that are still alive                                  
+   if (IsAsync())
+      ReleaseRepeats();
+
+   SetAsync(false);
+   delete mAttachments.load();
+   delete mFlight.load();
+}
+
+/// Get the number of tabulations for the line being written                  
+///   @return the number of tabs                                              
+size_t Interface::GetTabs() const noexcept {
+   return tContext.mTabulator;
+}
 
-/// Logger destruction                                                        
-Interface::~Interface() {}
+/// Get the intent of the line being written                                  
+///   @return the intent                                                      
+Intent Interface::GetIntent() const noexcept {
+   return tContext.mIntent;
+}
+
+/// Set the intent for the current thread                                     
+///   @param i - the intent                                                   
+void Interface::SetIntent(Intent i) noexcept {
+   tContext.mIntent = i;
+   tContext.mMuted = i < Intent::Counter
+      and (mSilenced.load(::std::memory_order_relaxed) & (1u << int(i)));
+
+   // A fatal error dumps a running flight recorder, even if fatal      
+   // errors aren't recorded                                            
+   if (i == Intent::FatalError and mFlightIntents.load(::std::memory_order_relaxed))
+      Inner::FlightRecorder::MarkFatal();
+}
+
+/// Get the time at which the line being written was started                  
+///   @return the time point                                                  
+TimePoint Interface::GetLineTime() const noexcept {
+   return tContext.mLineTime;
+}
+
+/// Cache of formatted timestamps for the current thread - the text is only   
+/// regenerated when the time changes at the required precision, and the      
+/// local time offset is cached, so that the time zone lock isn't taken for   
+/// every line                                                                
+struct TimeCache {
+   static constexpr auto Never = ::std::numeric_limits<int64_t>::min();
+
+   // Local time offset from UTC, valid until the given UTC second      
+   int64_t mOffset = 0;
+   int64_t mOffsetExpiry = Never;
+
+   // Simple timestamp, and the time it was generated for               
+   int64_t mSimpleKey = Never;
+   Precision mSimplePrecision = Precision::Seconds;
+   size_t mSimpleSize = 0;
+   Letter mSimple[32];
+
+   // Advanced timestamp, and the second it was generated for           
+   int64_t mAdvancedKey = Never;
+   size_t mAdvancedSize = 0;
+   Letter mAdvanced[96];
+
+   int64_t GetOffset(int64_t utc);
+};
+
+thread_local TimeCache tTimeCache;
+
+/// Get the local time offset from UTC for a given moment                     
+/// Offset is recalculated once every quarter of an hour, which is the finest 
+/// granularity of daylight saving time transitions                           
+///   @param utc - seconds since epoch                                        
+///   @return the offset in seconds                                           
+int64_t TimeCache::GetOffset(int64_t utc) {
+   if (utc >= mOffsetExpiry or utc < mOffsetExpiry - 900) {
+      // Interpret the local broken-down time as if it was UTC, and     
+      // compare against the real UTC (days from civil algorithm)       
+      const auto local = fmt::localtime(static_cast<::std::time_t>(utc));
+      const int64_t y = local.tm_year + 1900 - (local.tm_mon < 2);
+      const int64_t era = (y >= 0 ? y : y - 399) / 400;
+      const int64_t yoe = y - era * 400;
+      const int64_t m = local.tm_mon + 1;
+      const int64_t doy = (153 * (m > 2 ? m - 3 : m + 9) + 2) / 5 + local.tm_mday - 1;
+      const int64_t doe = yoe * 365 + yoe / 4 - yoe / 100 + doy;
+      const int64_t days = era * 146097 + doe - 719468;
+      const int64_t asUtc = days * 86400 + local.tm_hour * 3600
+                          + local.tm_min * 60 + local.tm_sec;
+
+      mOffset = asUtc - utc;
+      mOffsetExpiry = (utc / 900 + 1) * 900;
+   }
+
+   return mOffset;
+}
 
 /// Generate an exhaustive timestamp in the current system time zone          
 ///   @return the timestamp text as {:%F %T %Z}                               
 Text Logger::A::Interface::GetAdvancedTime() noexcept {
-   try {
-      const auto now = Clock::to_time_t(Clock::now());
-      return fmt::format("{:%F %T %Z}", fmt::localtime(now));
+   return GetAdvancedTime(TimePoint::clock::now());
+}
+
+/// Generate an exhaustive timestamp in the current system time zone          
+///   @param time - the time to format                                        
+///   @return the timestamp text as {:%F %T %Z}                               
+Text Logger::A::Interface::GetAdvancedTime(TimePoint time) noexcept {
+   try { return Text {GetAdvancedTimeView(time)}; }
+   catch (...) { return {}; }
+}
+
+/// Generate an exhaustive timestamp in the current system time zone, without 
+/// allocating - the text is cached for the current thread                    
+///   @attention the view is valid until the next call in the same thread     
+///   @return the timestamp text as {:%F %T %Z}                               
+TextView Logger::A::Interface::GetAdvancedTimeView() noexcept {
+   return GetAdvancedTimeView(TimePoint::clock::now());
+}
+
+/// Generate an exhaustive timestamp in the current system time zone          
+///   @attention the view is valid until the next call in the same thread     
+///   @param time - the time to format                                        
+///   @return the timestamp text as {:%F %T %Z}                               
+TextView Logger::A::Interface::GetAdvancedTimeView(TimePoint time) noexcept {
+   auto& cache = tTimeCache;
+   const auto now = TimePoint::clock::to_time_t(time);
+   if (now != cache.mAdvancedKey) {
+      try {
+         const auto result = fmt::format_to_n(cache.mAdvanced,
+            sizeof(cache.mAdvanced), "{:%F %T %Z}", fmt::localtime(now));
+         cache.mAdvancedSize = ::std::min(result.size, sizeof(cache.mAdvanced));
+         cache.mAdvancedKey = now;
+      }
+      catch (...) { return "<advanced time error>"; }
    }
-   catch (...) { return "<advanced time error>"; }
+
+   return {cache.mAdvanced, cache.mAdvancedSize};
 }
 
-/// Generate a short timestamp in the current system time zone                
-///   @return the timestamp text as {:%T}                                     
+/// Generate a short timestamp in the current system time zone, with the      
+/// precision configured in Instance.TimeStampPrecision                       
+///   @return the timestamp text as {:%T}, with optional fraction             
 Text Logger::A::Interface::GetSimpleTime() noexcept {
+   return GetSimpleTime(TimePoint::clock::now());
+}
+
+/// Generate a short timestamp in the current system time zone, with the      
+/// precision configured in Instance.TimeStampPrecision                       
+///   @param time - the time to format                                        
+///   @return the timestamp text as {:%T}, with optional fraction             
+Text Logger::A::Interface::GetSimpleTime(TimePoint time) noexcept {
+   try { return Text {GetSimpleTimeView(time)}; }
+   catch (...) { return {}; }
+}
+
+/// Generate a short timestamp in the current system time zone, without       
+/// allocating - the text is cached for the current thread                    
+///   @attention the view is valid until the next call in the same thread     
+///   @return the timestamp text as {:%T}, with optional fraction             
+TextView Logger::A::Interface::GetSimpleTimeView() noexcept {
+   return GetSimpleTimeView(TimePoint::clock::now());
+}
+
+/// Generate a short timestamp in the current system time zone, with the      
+/// precision configured in Instance.TimeStampPrecision                       
+///   @attention the view is valid until the next call in the same thread     
+///   @param time - the time to format                                        
+///   @return the timestamp text as {:%T}, with optional fraction             
+TextView Logger::A::Interface::GetSimpleTimeView(TimePoint time) noexcept {
+   using namespace ::std::chrono;
+   auto& cache = tTimeCache;
+   const auto precision = Instance.TimeStampPrecision;
+   const auto us = floor<microseconds>(time.time_since_epoch()).count();
+   const auto utc = floor<seconds>(time.time_since_epoch()).count();
+
+   int64_t key;
+   switch (precision) {
+   case Precision::Milliseconds:
+      key = floor<milliseconds>(time.time_since_epoch()).count();
+      break;
+   case Precision::Microseconds:
+      key = us;
+      break;
+   default:
+      key = utc;
+   }
+
+   if (key == cache.mSimpleKey and precision == cache.mSimplePrecision)
+      return {cache.mSimple, cache.mSimpleSize};
+
    try {
-      const auto now = Clock::to_time_t(Clock::now());
-      return fmt::format("{:%T}", fmt::localtime(now));
+      // Time of day in local time                                      
+      const auto local = utc + cache.GetOffset(utc);
+      const auto day = ((local % 86400) + 86400) % 86400;
+      auto out = fmt::format_to(cache.mSimple, "{:02}:{:02}:{:02}",
+         day / 3600, day / 60 % 60, day % 60);
+
+      const auto fraction = us - utc * 1'000'000;
+      if (precision == Precision::Milliseconds)
+         out = fmt::format_to(out, ".{:03}", fraction / 1000);
+      else if (precision == Precision::Microseconds)
+         out = fmt::format_to(out, ".{:06}", fraction);
+
+      cache.mSimpleSize = out - cache.mSimple;
+      cache.mSimpleKey = key;
+      cache.mSimplePrecision = precision;
    }
    catch (...) { return "<simple time error>"; }
+
+   return {cache.mSimple, cache.mSimpleSize};
 }
 
 /// Write a string view to stdout                                             
 ///   @param stdString - the text view to write                               
 void Interface::Write(const TextView& stdString) const noexcept {
-   if (CurrentIntent == Intent::Ignore)
+   if (tContext.mIntent == Intent::Ignore)
+      return;
+
+   if (auto flight = Recording())
+      flight->Write(stdString);
+   if (tContext.mMuted)
       return;
 
+   // Split the text into as many records, as required                  
+   auto text = stdString;
+   do {
+      Inner::Record record;
+      record.type = Inner::Record::Text;
+      record.intent = tContext.mIntent;
+      record.tabs = static_cast<uint32_t>(tContext.mTabulator);
+      record.size = static_cast<uint16_t>(
+         ::std::min(text.size(), Inner::Record::Capacity));
+      ::std::memcpy(record.text, text.data(), record.size);
+      Enqueue(record);
+      text.remove_prefix(record.size);
+   }
+   while (not text.empty());
+}
+
+/// Change the style                                                          
+///   @param s - the style                                                    
+void Interface::Write(Style s) const noexcept {
+   if (tContext.mIntent == Intent::Ignore or tContext.mMuted)
+      return;
+
+   Inner::Record record;
+   record.type = Inner::Record::Stylize;
+   record.intent = tContext.mIntent;
+   record.tabs = static_cast<uint32_t>(tContext.mTabulator);
+   record.style = s;
+   record.size = 0;
+   Enqueue(record);
+}
+
+/// Write a value, that is formatted only when its statement is dispatched,   
+/// by the background thread in async mode                                    
+///   @param format - the function that formats the value                     
+///   @param data - the bytes of the value                                    
+///   @param size - the number of bytes, at most Inner::MaxDeferredSize       
+void Interface::WriteDeferred(Inner::Formatter format, const void* data, size_t size) const noexcept {
+   if (tContext.mIntent == Intent::Ignore)
+      return;
+
+   if (auto flight = Recording())
+      flight->WriteDeferred(format, data, size);
+   if (tContext.mMuted)
+      return;
+
+   Inner::Record record;
+   record.type = Inner::Record::Deferred;
+   record.intent = tContext.mIntent;
+   record.tabs = static_cast<uint32_t>(tContext.mTabulator);
+   record.formatter = format;
+   record.size = static_cast<uint16_t>(size);
+   ::std::memcpy(record.text, data, size);
+   Enqueue(record);
+}
+
+/// Add a new line, tabulating properly, but continuing the previous style    
+void Interface::NewLine() const noexcept {
+   if (tContext.mIntent == Intent::Ignore)
+      return;
+
+   if (tContext.mStyleStack.empty())
+      tContext.mStyleStack.push(GetCurrentStyle());
+
+   // The clock is read only once per line, for all attachments         
+   tContext.mLineTime = TimePoint::clock::now();
+
+   if (auto flight = Recording()) {
+      flight->NewLine(tContext.mIntent,
+         static_cast<uint32_t>(tContext.mTabulator), tContext.mLineTime);
+   }
+   if (tContext.mMuted)
+      return;
+
+   Inner::Record record;
+   record.type = Inner::Record::NewLine;
+   record.intent = tContext.mIntent;
+   record.tabs = static_cast<uint32_t>(tContext.mTabulator);
+   record.time = tContext.mLineTime;
+   record.style = tContext.mStyleStack.top();
+   record.size = 0;
+   Enqueue(record);
+}
+
+/// Clear the entire log (clear the console window or file)                   
+void Interface::Clear() const noexcept {
+   Inner::Record record;
+   record.type = Inner::Record::Clear;
+   record.intent = tContext.mIntent;
+   record.tabs = static_cast<uint32_t>(tContext.mTabulator);
+   record.size = 0;
+   Enqueue(record);
+}
+
+/// Save the current thread's context                                         
+Inner::SavedContext::SavedContext() noexcept {
+   auto& context = tContext;
+   mIntent = context.mIntent;
+   mTabs = context.mTabulator;
+   mTime = context.mLineTime;
+   mStyled = not context.mStyleStack.empty();
+   mStyle = mStyled ? context.mStyleStack.top() : Style {};
+}
+
+/// Restore the thread's context, as it was when saved                        
+Inner::SavedContext::~SavedContext() noexcept {
+   auto& context = tContext;
+   context.mIntent = mIntent;
+   context.mTabulator = mTabs;
+   context.mLineTime = mTime;
+   if (mStyled)
+      context.mStyleStack.top() = mStyle;
+   else while (not context.mStyleStack.empty())
+      context.mStyleStack.pop();
+}
+
+/// Set up the current thread's context from a record, because attachments    
+/// query the intent, tabs and style of the line from it                      
+///   @param record - the record that is about to be dispatched               
+void Inner::UseContext(const Record& record) noexcept {
+   auto& context = tContext;
+   context.mIntent = record.intent;
+   context.mTabulator = record.tabs;
+   if (record.type == Record::NewLine)
+      context.mLineTime = record.time;
+   if (record.type == Record::Stylize
+   or  record.type == Record::NewLine) {
+      if (context.mStyleStack.empty())
+         context.mStyleStack.push(record.style);
+      else
+         context.mStyleStack.top() = record.style;
+   }
+}
+
+/// Dispatch a record, that was staged or released by a logging thread        
+///   @param record - the record to write                                     
+void Interface::Dispatch(const Inner::Record& record) const noexcept {
+   Inner::UseContext(record);
+   tLinesWhole = record.ends;
+
+   switch (record.type) {
+   case Inner::Record::Text:
+      DispatchText({record.text, record.size});
+      break;
+   case Inner::Record::Stylize:
+      DispatchStyle(record.style);
+      break;
+   case Inner::Record::NewLine:
+      DispatchNewLine();
+      break;
+   case Inner::Record::Clear:
+      DispatchClear();
+      break;
+   case Inner::Record::Flush:
+      DispatchFlush();
+      break;
+   case Inner::Record::Deferred: {
+      ::fmt::memory_buffer formatted;
+      record.formatter(record.text, formatted);
+      DispatchText({formatted.data(), formatted.size()});
+      break;
+   }
+   }
+}
+
+/// Hand a whole statement over to the async worker, or dispatch it right     
+/// away, restoring the current thread's context afterwards                   
+///   @param records - the statement's records                                
+///   @param count - the number of records                                    
+void Interface::Release(Inner::Record* records, size_t count) const noexcept {
+   if (not count)
+      return;
+
+   if (auto worker = mAsync.load(::std::memory_order_acquire)) {
+      records[count - 1].ends = true;
+      worker->Push(records, count);
+      return;
+   }
+
+   // Dispatching sets up the context from each record, but the thread  
+   // has already moved past them                                       
+   const ::std::scoped_lock lock {mStatements};
+   const Inner::SavedContext saved;
+   for (size_t i = 0; i < count; ++i)
+      Dispatch(records[i]);
+   ConsoleCommit(true);
+   DeliverRecords();
+}
+
+/// Write what would otherwise be lost on a crash - the buffered console      
+/// output, and the text of the records waiting in the async queue,           
+/// which is written to stderr as it is, without styles or timestamps. Uses   
+/// raw writes only, so that it can be done from a signal handler             
+void Interface::Salvage() const noexcept {
+#ifdef _WIN32
+   const auto write = [](int fd, const Letter* data, size_t size) {
+      ::_write(fd, data, static_cast<unsigned>(size));
+   };
+   constexpr int Stdout = 1;
+   constexpr int Stderr = 2;
+#else
+   const auto write = [](int fd, const Letter* data, size_t size) {
+      while (size) {
+         const auto written = ::write(fd, data, size);
+         if (written <= 0) {
+            if (written < 0 and errno == EINTR)
+               continue;
+            break;
+         }
+
+         data += written;
+         size -= static_cast<size_t>(written);
+      }
+   };
+   constexpr int Stdout = STDOUT_FILENO;
+   constexpr int Stderr = STDERR_FILENO;
+#endif
+
+   // Whole lines come before the current thread's partial one, the     
+   // lock can't be taken here                                          
+   auto& shared = GetSharedConsole();
+   if (shared.mAlive and shared.mBuffer.size()) {
+      write(shared.mStream == stderr ? Stderr : Stdout,
+         shared.mBuffer.data(), shared.mBuffer.size());
+      shared.mBuffer.clear();
+   }
+
+   const auto console = tConsoleBuffer;
+   if (console and console->mBuffer.size()) {
+      write(console->mStream == stderr ? Stderr : Stdout,
+         console->mBuffer.data(), console->mBuffer.size());
+      console->mBuffer.clear();
+   }
+
+   // Deferred values can't be formatted here, fmt might allocate       
+   if (auto worker = mAsync.load(::std::memory_order_acquire)) {
+      worker->Peek([&](const Inner::Record& record) {
+         switch (record.type) {
+         case Inner::Record::Text:
+            write(Stderr, record.text, record.size);
+            break;
+         case Inner::Record::Deferred:
+            write(Stderr, "<?>", 3);
+            break;
+         case Inner::Record::NewLine:
+            write(Stderr, "\n", 1);
+            break;
+         default:
+            break;
+         }
+      });
+   }
+}
+
+/// Check if the current intent goes to the flight recorder                   
+///   @return the flight recorder, or nullptr if it doesn't                   
+Inner::FlightRecorder* Interface::Recording() const noexcept {
+   const auto intent = tContext.mIntent;
+   if (intent >= Intent::Counter
+   or not (mFlightIntents.load(::std::memory_order_relaxed) & (1u << int(intent))))
+      return nullptr;
+   return mFlight.load(::std::memory_order_acquire);
+}
+
+/// Write a string view to stdout and attachments                             
+///   @param stdString - the text view to write                               
+void Interface::DispatchText(const TextView& stdString) const noexcept {
+   const Reading attachments {*this};
+   const auto intent = GetIntent();
+
+   // Assemble the line for record sinks                                
+   if (attachments.IsRecorded(intent)) {
+      if (not tLines.IsOpen())
+         tLines.Begin(false, GetLineTime(), intent, GetTabs(), GetCurrentStyle());
+      tLines.Write(stdString);
+   }
+
    // Dispatch to redirectors                                           
-   if (not mRedirectors.empty()) {
-      for (auto attachment : mRedirectors)
+   if (attachments.IsRedirected(intent)) {
+      for (auto attachment : attachments.Redirectors(intent))
          attachment->Write(stdString);
 
-      // The presence of a redirector blocks console printing           
+      // The presence of a redirector, that receives this intent,       
+      // blocks console printing                                        
       return;
    }
 
-   try { fmt::print("{}", stdString); }
+   try { tConsole.Append(GetConsole(ConsoleFlush), stdString); }
    catch (...) { Logger::Append("<logger error>"); }
-
-   // Always flush                                                      
-   fflush(stdout);
+   ConsoleCommit(false);
 
    // Dispatch to duplicators                                           
-   for (auto attachment : mDuplicators)
+   for (auto attachment : attachments.Duplicators(intent))
       attachment->Write(stdString);
 }
 
-/// Change the style                                                          
+/// Change the style of stdout and attachments                                
 ///   @param s - the style                                                    
-void Interface::Write(Style s) const noexcept {
-   if (CurrentIntent == Intent::Ignore)
-      return;
+void Interface::DispatchStyle(Style s) const noexcept {
+   const Reading attachments {*this};
+   const auto intent = GetIntent();
+
+   // Assemble the line for record sinks - a line, that is yet to begin,
+   // picks its style up on its own                                     
+   if (attachments.IsRecorded(intent) and tLines.IsOpen())
+      tLines.Write(s);
 
    // Dispatch to redirectors                                           
-   if (not mRedirectors.empty()) {
-      for (auto attachment : mRedirectors)
+   if (attachments.IsRedirected(intent)) {
+      for (auto attachment : attachments.Redirectors(intent))
          attachment->Write(s);
 
-      // The presence of a redirector blocks console printing           
+      // The presence of a redirector, that receives this intent,       
+      // blocks console printing                                        
       return;
    }
 
-   FmtPrintStyle(s);
+   try { FmtPrintStyle(GetConsole(ConsoleFlush), s); }
+   catch (...) { Logger::Append("<logger error>"); }
+   ConsoleCommit(false);
 
    // Dispatch to duplicators                                           
-   for (auto attachment : mDuplicators)
+   for (auto attachment : attachments.Duplicators(intent))
       attachment->Write(s);
 }
 
-/// Add a new line, tabulating properly, but continuing the previous style    
-void Interface::NewLine() const noexcept {
-   if (CurrentIntent == Intent::Ignore)
-      return;
+/// Add a new line to stdout and attachments                                  
+void Interface::DispatchNewLine() const noexcept {
+   const Reading attachments {*this};
+   const auto intent = GetIntent();
+
+   // Begin a line for record sinks, delivering the previous lines      
+   // first, if there are enough of them                                
+   if (attachments.IsRecorded(intent)) {
+      if (tLines.IsFull())
+         attachments.Deliver(tLines.Take());
+      tLines.Begin(true, GetLineTime(), intent, GetTabs(), GetCurrentStyle());
+   }
 
    // Dispatch to redirectors                                           
-   if (not mRedirectors.empty()) {
-      for (auto attachment : mRedirectors)
+   if (attachments.IsRedirected(intent)) {
+      for (auto attachment : attachments.Redirectors(intent))
          attachment->NewLine();
 
-      // The presence of a redirector blocks console printing           
+      // The presence of a redirector, that receives this intent,       
+      // blocks console printing                                        
       return;
    }
 
-   // Clear formatting, add new line, simple time stamp, and tabs       
-   fmt::print("\n");
-   FmtPrintStyle(TimeStampStyle);
+   // The previous line ends here                                       
+   ConsoleCommit(true);
 
-   if (CurrentIntent == Intent::Ignore)
-      fmt::print("{}| | ",  GetSimpleTime());
-   else
-      fmt::print("{}|{}| ", GetSimpleTime(), IntentStyle[int(CurrentIntent)].prefix);
-
-   if (mTabulator) {
-      auto tabs = mTabulator;
-      FmtPrintStyle(TabStyle);
-      while (tabs) {
-         fmt::print("{}", TabString);
-         --tabs;
+   // Clear formatting, add new line, simple time stamp, and tabs       
+   try {
+      const auto stream = GetConsole(ConsoleFlush);
+      tConsole.Append(stream, "\n");
+      FmtPrintStyle(stream, TimeStampStyle);
+
+      tConsole.Append(stream, GetSimpleTimeView(GetLineTime()));
+      if (intent == Intent::Ignore)
+         tConsole.Append(stream, "| | ");
+      else {
+         tConsole.Append(stream, "|");
+         tConsole.Append(stream, IntentStyle[int(intent)].prefix);
+         tConsole.Append(stream, "| ");
       }
-   }
 
-   if (mStyleStack.empty()) {
-      const_cast<decltype(mStyleStack)&>(mStyleStack)
-         .push(GetCurrentStyle());
+      if (auto tabs = GetTabs()) {
+         FmtPrintStyle(stream, TabStyle);
+         while (tabs) {
+            tConsole.Append(stream, TabString);
+            --tabs;
+         }
+      }
    }
+   catch (...) { Logger::Append("<logger error>"); }
 
-   FmtPrintStyle(mStyleStack.top());
+   const auto style = GetCurrentStyle();
+   try { FmtPrintStyle(GetConsole(ConsoleFlush), style); }
+   catch (...) { Logger::Append("<logger error>"); }
+   ConsoleCommit(false);
 
    // Dispatch to duplicators                                           
-   for (auto attachment : mDuplicators) {
+   for (auto attachment : attachments.Duplicators(intent)) {
       attachment->NewLine();
-      attachment->Write(mStyleStack.top());
+      attachment->Write(style);
    }
 }
 
-/// Clear the entire log (clear the console window or file)                   
-void Interface::Clear() const noexcept {
+/// Clear the console window and attachments                                  
+void Interface::DispatchClear() const noexcept {
+   DeliverRecords();
+   const Reading attachments {*this};
+
    // Dispatch to redirectors                                           
-   if (not mRedirectors.empty()) {
-      for (auto attachment : mRedirectors)
-         attachment->Clear();
+   if (not attachments.Redirectors().empty()) {
+      for (auto& attachment : attachments.Redirectors())
+         attachment.mSink->Clear();
 
       // The presence of a redirector blocks console printing           
       return;
    }
 
    // Clear the window                                                  
-   fmt::print("{}", "\x1b[2J");
+   try { tConsole.Append(GetConsole(ConsoleFlush), "\x1b[2J"); }
+   catch (...) { Logger::Append("<logger error>"); }
+   ConsoleCommit(false);
 
    // Dispatch to duplicators                                           
-   for (auto attachment : mDuplicators)
-      attachment->Clear();
+   for (auto& attachment : attachments.Duplicators())
+      attachment.mSink->Clear();
+}
+
+/// Hand the console output, that was assembled by the current thread, over   
+/// at the end of a line, and write the shared console, if the flush policy   
+/// says so. Partial lines stay with the thread, unless the policy is due     
+///   @param endOfLine - whether a line or statement has just ended           
+void Interface::ConsoleCommit(bool endOfLine) const noexcept {
+   using namespace ::std::chrono;
+   auto& console = tConsole;
+   auto& shared = GetSharedConsole();
+   const auto pending = console.mBuffer.size()
+      + shared.mPending.load(::std::memory_order_relaxed);
+   if (pending == 0)
+      return;
+
+   const auto elapsed = steady_clock::duration {
+      steady_clock::now().time_since_epoch().count()
+      - shared.mLastCommit.load(::std::memory_order_relaxed)};
+   bool due = ConsoleFlush.IsDue(pending, elapsed, endOfLine, tContext.mIntent);
+
+   // Without a worker, nothing checks the interval, until something    
+   // else is logged, so don't hold the end of a statement back         
+   if (endOfLine and ConsoleFlush.mode == FlushPolicy::Interval and not IsAsync())
+      due = true;
+
+   if (due or endOfLine)
+      console.HandOver(due);
+}
+
+/// Write the console output of the current thread, and all whole lines of    
+/// the other threads, regardless of the flush policy                         
+void Interface::ConsoleFlushNow() const noexcept {
+   tConsole.HandOver(true);
+}
+
+/// Write anything that is buffered by the console and attachments            
+void Interface::DispatchFlush() const noexcept {
+   ConsoleFlushNow();
+   DeliverRecords();
+
+   const Reading attachments {*this};
+   for (auto& attachment : attachments.Redirectors())
+      attachment.mSink->Flush();
+   for (auto& attachment : attachments.Duplicators())
+      attachment.mSink->Flush();
+}
+
+/// Give record sinks the lines, that the current thread has assembled        
+///   @param onlyWhole - deliver only if the last statement was dispatched    
+///      whole, used when the async worker runs out of records                
+void Interface::DeliverRecords(bool onlyWhole) const noexcept {
+   if (not tLines.IsOpen() or (onlyWhole and not tLinesWhole))
+      return;
+
+   const Reading attachments {*this};
+   attachments.Deliver(tLines.Take());
+}
+
+/// Check if buffered output should be written                                
+///   @param pending - number of buffered bytes                               
+///   @param elapsed - time since the buffer was last written                 
+///   @param endOfLine - whether a line or statement has just ended           
+///   @param intent - the intent of the line, that is buffered last, or that  
+///      has just ended                                                       
+///   @return true if the buffer should be written now                        
+bool FlushPolicy::IsDue(
+   size_t pending, ::std::chrono::steady_clock::duration elapsed,
+   bool endOfLine, Intent intent
+) const noexcept {
+   switch (mode) {
+   case Immediate:
+      return true;
+   case PerLine:
+      if (endOfLine)
+         return true;
+      break;
+   case PerBytes:
+      if (pending >= bytes)
+         return true;
+      break;
+   case Interval:
+      if (elapsed >= interval)
+         return true;
+      break;
+   }
+
+   // Errors are written as whole lines, not fragment by fragment       
+   return endOfLine and errorsImmediate and IsError(intent);
+}
+
+/// Silence an intent at runtime - statements with it will be ignored,        
+/// without even formatting their arguments                                   
+///   @param i - the intent to silence                                        
+void Interface::Silence(Intent i) noexcept {
+   if (i < Intent::Counter)
+      mSilenced.fetch_or(1u << int(i), ::std::memory_order_relaxed);
+}
+
+/// Restore a silenced intent                                                 
+///   @param i - the intent to restore                                        
+void Interface::Unsilence(Intent i) noexcept {
+   if (i < Intent::Counter)
+      mSilenced.fetch_and(~(1u << int(i)), ::std::memory_order_relaxed);
 }
 
 /// Execute a logger command                                                  
@@ -229,54 +1337,54 @@ void Interface::RunCommand(Command c) noexcept {
       break;
    case Command::Invert:
       SetEmphasis(Emphasis::Reverse);
-      Write(mStyleStack.top());
+      Write(tContext.mStyleStack.top());
       break;
    case Command::Reset:
-      while (not mStyleStack.empty())
-         mStyleStack.pop();
+      while (not tContext.mStyleStack.empty())
+         tContext.mStyleStack.pop();
 
-      if (CurrentIntent == Intent::Ignore)
-         CurrentIntent = DefaultIntent;
+      if (tContext.mIntent == Intent::Ignore)
+         tContext.mIntent = DefaultIntent;
 
-      mStyleStack.push(GetCurrentStyle());
-      Write(mStyleStack.top());
+      tContext.mStyleStack.push(GetCurrentStyle());
+      Write(tContext.mStyleStack.top());
       break;
    case Command::Time:
-      Write(GetSimpleTime());
+      Write(GetSimpleTimeView());
       break;
    case Command::ExactTime:
-      Write(GetAdvancedTime());
+      Write(GetAdvancedTimeView());
       break;
    case Command::Pop:
-      if (not mStyleStack.empty())
-         mStyleStack.pop();
+      if (not tContext.mStyleStack.empty())
+         tContext.mStyleStack.pop();
 
-      if (mStyleStack.empty())
-         mStyleStack.push(GetCurrentStyle());
+      if (tContext.mStyleStack.empty())
+         tContext.mStyleStack.push(GetCurrentStyle());
 
-      Write(mStyleStack.top());
+      Write(tContext.mStyleStack.top());
       break;
    case Command::Push:
-      mStyleStack.push(mStyleStack.top());
+      tContext.mStyleStack.push(tContext.mStyleStack.top());
       break;
    case Command::PopAndPush:
-      if (not mStyleStack.empty())
-         mStyleStack.pop();
+      if (not tContext.mStyleStack.empty())
+         tContext.mStyleStack.pop();
 
-      mStyleStack.push(mStyleStack.top());
+      tContext.mStyleStack.push(tContext.mStyleStack.top());
       break;
    case Command::Stylize:
-      if (mStyleStack.empty())
-         mStyleStack.push(GetCurrentStyle());
+      if (tContext.mStyleStack.empty())
+         tContext.mStyleStack.push(GetCurrentStyle());
 
-      Write(mStyleStack.top());
+      Write(tContext.mStyleStack.top());
       break;
    case Command::Tab:
-      ++mTabulator;
+      ++tContext.mTabulator;
       break;
    case Command::Untab:
-      if (mTabulator > 0)
-         --mTabulator;
+      if (tContext.mTabulator > 0)
+         --tContext.mTabulator;
       break;
    }
 }
@@ -285,20 +1393,20 @@ void Interface::RunCommand(Command c) noexcept {
 ///   @param c_with_flags - the color with optional mixing flags              
 ///   @return the last style, with coloring applied                           
 auto Interface::SetColor(Color c_with_flags) noexcept -> const Style& {
-   if (mStyleStack.empty())
-      mStyleStack.push(GetCurrentStyle());
+   if (tContext.mStyleStack.empty())
+      tContext.mStyleStack.push(GetCurrentStyle());
 
    if (static_cast<unsigned>(c_with_flags)
    &   static_cast<unsigned>(Color::PreviousColor)) {
       // We have to pop                                                 
-      if (mStyleStack.size() > 1)
-         mStyleStack.pop();
+      if (tContext.mStyleStack.size() > 1)
+         tContext.mStyleStack.pop();
    }
 
    if (static_cast<unsigned>(c_with_flags)
    &   static_cast<unsigned>(Color::NextColor)) {
       // We have to push                                                
-      mStyleStack.push(mStyleStack.top());
+      tContext.mStyleStack.push(tContext.mStyleStack.top());
    }
 
    // Strip the mixing bits from the color                              
@@ -310,7 +1418,7 @@ auto Interface::SetColor(Color c_with_flags) noexcept -> const Style& {
    );
 
    // Mix...                                                            
-   auto& style = mStyleStack.top();
+   auto& style = tContext.mStyleStack.top();
    const auto oldStyle = style;
    if (c == Color::NoForeground) {
       // Reset the foreground color                                     
@@ -346,10 +1454,10 @@ auto Interface::SetColor(Color c_with_flags) noexcept -> const Style& {
 /// Change the emphasis by modifying the current style                        
 ///   @param e - the emphasis                                                 
 auto Interface::SetEmphasis(Emphasis e) noexcept -> const Style& {
-   if (mStyleStack.empty())
-      mStyleStack.push(GetCurrentStyle());
+   if (tContext.mStyleStack.empty())
+      tContext.mStyleStack.push(GetCurrentStyle());
 
-   auto& style = mStyleStack.top();
+   auto& style = tContext.mStyleStack.top();
    style |= static_cast<fmt::emphasis>(e);
    return style;
 }
@@ -357,54 +1465,130 @@ auto Interface::SetEmphasis(Emphasis e) noexcept -> const Style& {
 /// Change the style by overwriting the current one                           
 ///   @param s - the style                                                    
 auto Interface::SetStyle(Style s) noexcept -> const Style& {
-   if (mStyleStack.empty())
-      mStyleStack.emplace(s);
+   if (tContext.mStyleStack.empty())
+      tContext.mStyleStack.emplace(s);
    else
-      mStyleStack.top() = s;
-   return mStyleStack.top();
+      tContext.mStyleStack.top() = s;
+   return tContext.mStyleStack.top();
 }
 
 /// Get the current style                                                     
 ///   @returns either the top of the style stack, or the style of the current 
 ///      intent (or a default style if current intent is Ignore)              
 auto Interface::GetCurrentStyle() const noexcept -> Style {
-   if (mStyleStack.empty()) {
-      if (CurrentIntent != Intent::Ignore)
-         return IntentStyle[int(CurrentIntent)].style;
+   if (tContext.mStyleStack.empty()) {
+      if (tContext.mIntent != Intent::Ignore)
+         return IntentStyle[int(tContext.mIntent)].style;
       else
          return {};
    }
-   else return mStyleStack.top();
+   else return tContext.mStyleStack.top();
 }
 
 /// Attach another logger, if no redirectors are attached, any logging        
 /// will be duplicated to the provided interface                              
 ///   @attention the logger doesn't have ownership of the attachment          
 ///   @param duplicator - the logger to attach                                
-void Interface::AttachDuplicator(A::Interface* duplicator) noexcept {
-   mDuplicators.push_back(duplicator);
+///   @param intents - the intents the duplicator receives, all by default    
+void Interface::AttachDuplicator(A::Interface* duplicator, IntentMask intents) noexcept {
+   ::std::scoped_lock lock {gAttachmentsMutex};
+   try {
+      const auto previous = mAttachments.load();
+      auto next = previous ? ::std::make_unique<Inner::Attachments>(*previous)
+                           : ::std::make_unique<Inner::Attachments>();
+      next->mDuplicators.push_back({duplicator, intents, duplicator->GetRecordSink()});
+      next->Index();
+      Publish(next.release());
+   }
+   catch (...) { Logger::Append("<logger error>"); }
 }
 
 /// Dettach a duplicator                                                      
-///   @attention the logger doesn't have ownership of the attachment          
+///   @attention the logger doesn't have ownership of the attachment. Once    
+///      this returns, the duplicator is no longer in use, and can be         
+///      destroyed, so don't call it from inside an attachment                
 ///   @param duplicator - the duplicator to dettach                           
 void Interface::DettachDuplicator(A::Interface* duplicator) noexcept {
-   mDuplicators.remove(duplicator);
+   // Make sure the duplicator receives everything that is queued. Skips
+   // of throttled call sites are reported only on explicit Flush       
+   FlushQueued();
+
+   ::std::scoped_lock lock {gAttachmentsMutex};
+   const auto previous = mAttachments.load();
+   if (not previous)
+      return;
+
+   try {
+      auto next = ::std::make_unique<Inner::Attachments>(*previous);
+      ::std::erase_if(next->mDuplicators, [&](const auto& attachment) {
+         return attachment.mSink == duplicator;
+      });
+      next->Index();
+      Publish(next.release());
+   }
+   catch (...) { Logger::Append("<logger error>"); }
 }
 
 /// Attach another logger, that will receive any logging, but also consume    
-/// it, so that it doesn't reach the console or any attached duplicators      
+/// it, so that it doesn't reach the console or any attached duplicators.     
+/// Intents, that the redirector doesn't receive, are not consumed by it      
 ///   @attention the logger doesn't have ownership of the attachment          
 ///   @param redirector - the logger to attach                                
-void Interface::AttachRedirector(A::Interface* redirector) noexcept {
-   mRedirectors.push_back(redirector);
+///   @param intents - the intents the redirector receives, all by default    
+void Interface::AttachRedirector(A::Interface* redirector, IntentMask intents) noexcept {
+   ::std::scoped_lock lock {gAttachmentsMutex};
+   try {
+      const auto previous = mAttachments.load();
+      auto next = previous ? ::std::make_unique<Inner::Attachments>(*previous)
+                           : ::std::make_unique<Inner::Attachments>();
+      next->mRedirectors.push_back({redirector, intents, redirector->GetRecordSink()});
+      next->Index();
+      Publish(next.release());
+   }
+   catch (...) { Logger::Append("<logger error>"); }
 }
 
 /// Dettach a redirector                                                      
-///   @attention the logger doesn't have ownership of the attachment          
+///   @attention the logger doesn't have ownership of the attachment. Once    
+///      this returns, the redirector is no longer in use, and can be         
+///      destroyed, so don't call it from inside an attachment                
 ///   @param redirector - the duplicator to dettach                           
 void Interface::DettachRedirector(A::Interface* redirector) noexcept {
-   mRedirectors.remove(redirector);
+   // Make sure the redirector receives everything that is queued. Skips
+   // of throttled call sites are reported only on explicit Flush       
+   FlushQueued();
+
+   ::std::scoped_lock lock {gAttachmentsMutex};
+   const auto previous = mAttachments.load();
+   if (not previous)
+      return;
+
+   try {
+      auto next = ::std::make_unique<Inner::Attachments>(*previous);
+      ::std::erase_if(next->mRedirectors, [&](const auto& attachment) {
+         return attachment.mSink == redirector;
+      });
+      next->Index();
+      Publish(next.release());
+   }
+   catch (...) { Logger::Append("<logger error>"); }
+}
+
+/// Replace the snapshot of attachments, and delete the previous one, once    
+/// every dispatch that might be reading it has finished                      
+///   @attention gAttachmentsMutex must be locked                             
+///   @param next - the new snapshot, the logger takes ownership of it        
+void Interface::Publish(const Inner::Attachments* next) noexcept {
+   const auto previous = mAttachments.exchange(next);
+
+   // Readers that start from now on count themselves in the new        
+   // generation, and can only see the new snapshot, so wait only for   
+   // the ones in the old generation                                    
+   const auto generation = mGeneration.fetch_add(1);
+   while (mReaders[generation & 1].load() != 0)
+      ::std::this_thread::yield();
+
+   delete previous;
 }
 
 /// Does nothing, but allows for grouping logging statements in ()            
@@ -468,7 +1652,7 @@ Logger::A::Interface& Logger::A::Interface::operator << (::std::nullptr_t) noexc
 ///   @return a reference to the logger for chaining                          
 Logger::A::Interface& Logger::A::Interface::operator << (Intent i) noexcept {
    if (i != Intent::Counter)
-      Instance.CurrentIntent = i;
+      Instance.SetIntent(i);
 
    if (i < Intent::Counter) {
       Instance.SetStyle(Instance.IntentStyle[int(i)].style);
@@ -490,6 +1674,17 @@ Logger::A::Interface& Logger::A::Interface::operator << (const Tabs& t) noexcept
    return *this;
 }
 
+/// Tell how many statements a throttled call site skipped, since the last    
+/// one that was written. The count is taken here, so it is kept if the       
+/// statement is silenced or compiled out                                     
+///   @param note - the throttled call site                                   
+///   @return a reference to the logger for chaining                          
+Logger::A::Interface& Logger::A::Interface::operator << (const Throttle::Note& note) noexcept {
+   if (const auto skipped = note.mThrottle.TakeSkipped())
+      *this << " (skipped " << skipped << " more)";
+   return *this;
+}
+
 /// Push a number of tabs                                                     
 /// Keeps track of the number of tabs that have been pushed, and then         
 /// automatically untabs when the Tabs object is destroyed                    
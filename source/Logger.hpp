@@ -17,13 +17,20 @@
 /// Make the rest of the code aware, that Langulus::Logger has been included  
 #define LANGULUS_LIBRARY_LOGGER() 1
 
-#include <stack>
-#include <list>
 #include <string_view>
 #include <string>
 #include <fmt/format.h>
 #include <fmt/color.h>
 #include <fstream>
+#include <atomic>
+#include <mutex>
+#include <memory>
+#include <chrono>
+#include <tuple>
+#include <bit>
+#include <cstring>
+#include <span>
+#include <algorithm>
 
 
 namespace Langulus::Logger
@@ -33,10 +40,22 @@ namespace Langulus::Logger
    using Text     = ::std::basic_string<Letter>;
    using TextView = ::std::basic_string_view<Letter>;
 
+   /// Point in time, used for timestamps                                     
+   using TimePoint = ::std::chrono::system_clock::time_point;
+
    template<class...T>
    concept Formattable = CT::Dense<T...>
        and ((::fmt::is_formattable<Deref<T>>::value) and ...);
 
+   /// Types, whose formatting is deferred to the background thread in async  
+   /// mode - their bytes are copied into the queue, and formatted later, so  
+   /// they must not refer to any other memory. Specialize it to enable this  
+   /// for your own trivially copyable types                                  
+   template<class T>
+   constexpr bool DeferredFormatting = ::std::is_arithmetic_v<T>
+       or ::std::is_enum_v<T>
+       or ::std::same_as<T, ::Langulus::Size>;
+
    /// Color codes, consistent with ANSI/VT100 escapes                        
    /// Also consistent with fmt::terminal_color                               
    enum class Color : unsigned {
@@ -280,11 +299,111 @@ namespace Langulus::Logger
       Ignore
    };
 
+   /// A set of intents, one bit for each, used to choose which intents an    
+   /// attachment receives. Combine intents with |, for example:              
+   ///    Logger::AttachDuplicator(&file, Intent::Error | Intent::Warning);   
+   struct IntentMask {
+      uint32_t mBits = (1u << int(Intent::Counter)) - 1;
+
+      /// All intents                                                         
+      constexpr IntentMask() noexcept = default;
+      /// A single intent                                                     
+      constexpr IntentMask(Intent i) noexcept
+         : mBits {i < Intent::Counter ? 1u << int(i) : 0u} {}
+
+      NOD() constexpr bool Contains(Intent i) const noexcept {
+         return i < Intent::Counter and (mBits & (1u << int(i)));
+      }
+
+      NOD() constexpr IntentMask operator | (IntentMask rhs) const noexcept {
+         IntentMask result;
+         result.mBits = mBits | rhs.mBits;
+         return result;
+      }
+
+      NOD() constexpr bool operator == (const IntentMask&) const noexcept = default;
+   };
+
+   constexpr IntentMask operator | (Intent lhs, Intent rhs) noexcept {
+      return IntentMask {lhs} | rhs;
+   }
+
+   /// Precision of the short timestamp at the beginning of each line         
+   enum class Precision : uint8_t {
+      Seconds,
+      Milliseconds,
+      Microseconds
+   };
+
+   /// Decides when console output, that is assembled in a buffer, is written 
+   /// Whole lines of all threads share the buffer, so the limits apply to    
+   /// the output of all threads together                                     
+   ///   @attention the console has no timer - the Interval mode is checked   
+   ///      on each write, and when the async worker runs out of work, so     
+   ///      without a worker, the console is written at the end of each       
+   ///      statement instead. Log files have a thread for the Interval mode, 
+   ///      that writes their buffer as soon as the interval passes           
+   struct FlushPolicy {
+      enum Mode : uint8_t {
+         Immediate,     // Write after every fragment
+         PerLine,       // Write at the end of each line and statement
+         PerBytes,      // Write when enough bytes have been assembled
+         Interval       // Write when enough time has passed
+      };
+
+      Mode mode = PerLine;
+      size_t bytes = 64 * 1024;
+      ::std::chrono::milliseconds interval {100};
+
+      // Flush lines of errors and fatal errors as soon as they end,    
+      // regardless of mode                                             
+      bool errorsImmediate = true;
+      // Write errors and fatal errors to the unbuffered stderr         
+      bool errorsToStderr = false;
+
+      NOD() LANGULUS_API(LOGGER) bool IsDue(
+         size_t pending,
+         ::std::chrono::steady_clock::duration elapsed,
+         bool endOfLine,
+         Intent intent
+      ) const noexcept;
+   };
+
+   /// Decides how a log file is buffered, written and synced to disk         
+   struct FilePolicy {
+      // When to write the buffer to the file                           
+      FlushPolicy flush {.mode = FlushPolicy::PerBytes};
+
+      // Size of the buffer, rounded up to whole pages                  
+      size_t buffer = 256 * 1024;
+
+      // Disk space is reserved ahead in chunks of this size, so that   
+      // appending doesn't fragment the file, zero to disable. Chunks   
+      // are at most rotateSize, if set, and the unused part is given   
+      // back when the file is closed or rotated                        
+      size_t preallocate = 16 * 1024 * 1024;
+
+      // When to sync the written data to the disk                      
+      enum Sync : uint8_t {
+         NeverSync,     // Leave it to the operating system
+         SyncErrors,    // Sync after errors and fatal errors
+         AlwaysSync     // Sync after every write to the file
+      } sync = SyncErrors;
+
+      // Start a new file, when the current one reaches a size or age,  
+      // zero disables. Old files are renamed to file.1.ext, file.2.ext 
+      // and so on, the most recent being file.1.ext                    
+      size_t rotateSize = 0;
+      ::std::chrono::seconds rotateInterval {0};
+
+      // Number of old files to keep, zero keeps all of them            
+      size_t rotateKeep = 0;
+   };
+
    /// Can be used to specify each intent's style and search patterns         
    struct IntentProperties {
       TextView prefix;
       Style style;
-      bool  silenced = false;
    };
 
    /// Tabulation marker (can be pushed to log)                               
@@ -307,9 +426,278 @@ namespace Langulus::Logger
       LANGULUS_API(LOGGER) ~ScopedTabs() noexcept;
    };
 
+   /// A message with a format string, that is checked at compile time, and   
+   /// rendered with a single fmt::format_to pass when pushed to the logger   
+   ///   @attention it only refers to its arguments, so push it in the same   
+   ///      statement it was created in                                       
+   template<class...T>
+   struct Formatted {
+      ::fmt::format_string<T...> mFormat;
+      ::std::tuple<const ::std::remove_reference_t<T>&...> mArguments;
+   };
+
+   /// Create a message from a compile-time checked format string             
+   ///   @param format - the format string                                    
+   ///   @param arguments... - the arguments                                  
+   ///   @return the message, ready to be pushed to the logger                
+   template<class...T> NOD() LANGULUS(INLINED)
+   Formatted<T...> Format(::fmt::format_string<T...> format, T&&...arguments) noexcept {
+      return {format, {arguments...}};
+   }
+
+   /// Scoped batch - everything the current thread logs during its lifetime  
+   /// is delivered at once, when the outermost batch is destroyed. All       
+   /// logging functions batch their arguments this way, so that a single     
+   /// statement is never interleaved with statements from other threads      
+   struct ScopedBatch {
+      ScopedBatch(const ScopedBatch&) = delete;
+      ScopedBatch& operator = (const ScopedBatch&) = delete;
+
+      LANGULUS_API(LOGGER)  ScopedBatch() noexcept;
+      LANGULUS_API(LOGGER) ~ScopedBatch() noexcept;
+   };
+
+   ///                                                                        
+   /// Statements skipped by a throttled call site. The count is reported at  
+   /// the end of the next statement that passes, or by Flush, so that it     
+   /// isn't lost if no statement passes anymore                              
+   ///                                                                        
+   class Throttle {
+      ::std::atomic<uint64_t> mSkipped {};
+      ::std::atomic<bool> mRegistered {};
+      Throttle* mNext = nullptr;
+
+      LANGULUS_API(LOGGER) void Register() noexcept;
+
+   protected:
+      /// Count a skipped statement, registering the call site for Flush      
+      void Skip() noexcept {
+         mSkipped.fetch_add(1, ::std::memory_order_relaxed);
+         if (not mRegistered.load(::std::memory_order_relaxed)
+         and not mRegistered.exchange(true))
+            Register();
+      }
+
+   public:
+      const TextView file;
+      const uint32_t line;
+      const Intent intent;
+
+      /// The skipped statements, appended to a statement, that passed, in    
+      /// the same batch. The count is taken only if the statement is written 
+      struct Note {
+         Throttle& mThrottle;
+      };
+
+      constexpr Throttle(const TextView& file, uint32_t line, Intent intent) noexcept
+         : file {file}, line {line}, intent {intent} {}
+
+      Throttle(const Throttle&) = delete;
+      Throttle& operator = (const Throttle&) = delete;
+
+      /// Get the number of statements skipped since the last call            
+      uint64_t TakeSkipped() noexcept {
+         return mSkipped.exchange(0, ::std::memory_order_relaxed);
+      }
+
+      /// Get the note for the statement that passed                          
+      Note Skipped() noexcept {
+         return {*this};
+      }
+
+      static void ReportSkipped() noexcept;
+   };
+
+   ///                                                                        
+   /// Throttle for a single call site, that lets only every Nth statement    
+   /// through. Made static by LANGULUS_LOG_EVERY                             
+   ///                                                                        
+   class Sampling : public Throttle {
+      const uint64_t mPeriod;
+      ::std::atomic<uint64_t> mHits {};
+
+   public:
+      constexpr Sampling(uint64_t period, const TextView& file, uint32_t line, Intent intent) noexcept
+         : Throttle {file, line, intent}
+         , mPeriod {period ? period : 1} {}
+
+      /// Count a hit on the call site                                        
+      ///   @return true if the statement should be logged                    
+      bool Pass() noexcept {
+         if (mHits.fetch_add(1, ::std::memory_order_relaxed) % mPeriod == 0)
+            return true;
+
+         Skip();
+         return false;
+      }
+   };
+
+   ///                                                                        
+   /// Throttle for a single call site, that lets at most K statements per    
+   /// second through, in bursts of up to K. It is a token bucket, kept as    
+   /// the time at which the bucket will be full again, so that a single      
+   /// atomic is enough. Made static by LANGULUS_LOG_RATE                     
+   ///                                                                        
+   class RateLimit : public Throttle {
+      // Nanoseconds it takes to earn a token                           
+      const int64_t mInterval;
+      // Nanoseconds worth of tokens the bucket holds, minus one token  
+      const int64_t mBurst;
+      ::std::atomic<int64_t> mFull {};
+
+   public:
+      constexpr RateLimit(uint64_t perSecond, const TextView& file, uint32_t line, Intent intent) noexcept
+         : Throttle {file, line, intent}
+         , mInterval {1'000'000'000 / static_cast<int64_t>(perSecond ? perSecond : 1)}
+         , mBurst {1'000'000'000 - mInterval} {}
+
+      /// Take a token for a hit on the call site                             
+      ///   @return true if the statement should be logged                    
+      bool Pass() noexcept {
+         const int64_t now = ::std::chrono::duration_cast<::std::chrono::nanoseconds>(
+            ::std::chrono::steady_clock::now().time_since_epoch()).count();
+
+         auto full = mFull.load(::std::memory_order_relaxed);
+         do {
+            if (full - mBurst > now) {
+               Skip();
+               return false;
+            }
+         }
+         while (not mFull.compare_exchange_weak(full,
+            ::std::max(full, now) + mInterval, ::std::memory_order_relaxed));
+         return true;
+      }
+   };
+
+   ///                                                                        
+   /// Description of a single logging statement, made static by LANGULUS_LOG 
+   /// at its call site. Call sites are kept in a registry from the static    
+   /// initialization of their module, even if they are never reached, so     
+   /// that tools can list them, and each of them can be switched on or off   
+   /// at runtime                                                             
+   ///   @attention call sites in functions, that are never compiled, like    
+   ///      templates that aren't instantiated, are not in the registry       
+   ///                                                                        
+   class CallSite {
+      ::std::atomic<bool> mEnabled {true};
+      CallSite* mNext = nullptr;
+
+   public:
+      const TextView file;
+      const uint32_t line;
+      const TextView function;
+      const Intent intent;
+      // The arguments of the statement, as they were written           
+      const TextView format;
+
+      LANGULUS_API(LOGGER) CallSite(const TextView& file, uint32_t line,
+         const TextView& function, Intent, const TextView& format) noexcept;
+
+      CallSite(const CallSite&) = delete;
+      CallSite& operator = (const CallSite&) = delete;
+
+      LANGULUS_API(LOGGER) static CallSite* First() noexcept;
+
+      /// Get the intent of a logging function by its name, as LANGULUS_LOG   
+      /// gets it - "Fatal" logs FatalError, and "NetworkTab" logs Network    
+      ///   @param function - the name of the logging function                
+      ///   @return the intent, or Ignore for functions without one           
+      NOD() static constexpr Intent IntentOf(TextView function) noexcept {
+         constexpr TextView names[] {
+            "Fatal", "Error", "Warning", "Verbose", "Info", "Message",
+            "Special", "Flow", "Input", "Network", "OS", "Prompt"
+         };
+         static_assert(::std::size(names) == size_t(Intent::Counter),
+            "Each intent must have a logging function");
+
+         if (function.ends_with("Tab"))
+            function.remove_suffix(3);
+         for (size_t i = 0; i < ::std::size(names); ++i) {
+            if (names[i] == function)
+               return static_cast<Intent>(i);
+         }
+         return Intent::Ignore;
+      }
+
+      /// Get the next call site in the registry                              
+      CallSite* Next() const noexcept {
+         return mNext;
+      }
+
+      /// Check if the call site logs anything                                
+      bool IsEnabled() const noexcept {
+         return mEnabled.load(::std::memory_order_relaxed);
+      }
+
+      /// Switch the call site on or off                                      
+      void Enable(bool enable) noexcept {
+         mEnabled.store(enable, ::std::memory_order_relaxed);
+      }
+   };
+
+   ///                                                                        
+   /// Registers the call site of LANGULUS_LOG at static initialization,      
+   /// instead of when it is first reached. SITE is a class local to the      
+   /// call site, that describes it with its static Make()                    
+   ///                                                                        
+   template<class SITE>
+   struct StaticCallSite {
+      static inline CallSite site = SITE::Make();
+   };
+
+   /// A piece of a line, written in a single style                           
+   struct LogRun {
+      Style style;
+      TextView text;
+   };
+
+   /// A whole line, as it is given to record sinks                           
+   struct LogRecord {
+      // When the line was started                                      
+      TimePoint time;
+      Intent intent;
+      uint32_t tabs;
+      // False if the record continues the line of the previous record, 
+      // i.e. if something was appended to a line that was delivered    
+      bool newLine;
+      // The text of the line, in the styles it was written in          
+      ::std::span<const LogRun> runs;
+   };
+
+   namespace Inner
+   {
+      struct Record;
+      class Worker;
+      class FileWriter;
+      class MappedFile;
+      class BinaryWriter;
+      class Lines;
+      struct Attachments;
+      class FlightRecorder;
+      struct CrashHandler;
+      struct RepeatsGuard;
+
+      /// Formats a value, whose bytes were copied, possibly on another thread
+      using Formatter = void(*)(const void*, ::fmt::memory_buffer&) noexcept;
+
+      /// The largest type that can be formatted in a deferred way            
+      constexpr size_t MaxDeferredSize = 64;
+
+      template<class T>
+      void FormatDeferred(const void*, ::fmt::memory_buffer&) noexcept;
+
+      template<class T>
+      concept Deferrable = DeferredFormatting<T>
+          and ::std::is_trivially_copyable_v<T>
+          and sizeof(T) <= MaxDeferredSize;
+   }
+
    namespace A
    {
 
+      struct RecordSink;
+
       ///                                                                     
       /// The abstract logger interface - override this to define attachments 
       ///                                                                     
@@ -325,13 +713,34 @@ namespace Langulus::Logger
          NOD() LANGULUS_API(LOGGER)
          static Text GetAdvancedTime() noexcept;
          NOD() LANGULUS_API(LOGGER)
+         static Text GetAdvancedTime(TimePoint) noexcept;
+         NOD() LANGULUS_API(LOGGER)
          static Text GetSimpleTime() noexcept;
+         NOD() LANGULUS_API(LOGGER)
+         static Text GetSimpleTime(TimePoint) noexcept;
+
+         NOD() LANGULUS_API(LOGGER)
+         static TextView GetAdvancedTimeView() noexcept;
+         NOD() LANGULUS_API(LOGGER)
+         static TextView GetAdvancedTimeView(TimePoint) noexcept;
+         NOD() LANGULUS_API(LOGGER)
+         static TextView GetSimpleTimeView() noexcept;
+         NOD() LANGULUS_API(LOGGER)
+         static TextView GetSimpleTimeView(TimePoint) noexcept;
 
          virtual void Write(const TextView&) const noexcept = 0;
          virtual void Write(Style) const noexcept = 0;
          virtual void NewLine() const noexcept = 0;
          virtual void Clear() const noexcept = 0;
 
+         /// Write anything the attachment has buffered                       
+         virtual void Flush() const noexcept {}
+
+         /// Get the attachment as a record sink, if it is one                
+         virtual const RecordSink* GetRecordSink() const noexcept {
+            return nullptr;
+         }
+
          /// Implicit bool operator in order to use log in 'if' statements    
          /// Example: if (condition && Logger::Info("stuff"))                 
          ///   @return true                                                   
@@ -350,12 +759,48 @@ namespace Langulus::Logger
 
          LANGULUS_API(LOGGER) Interface& operator << (const Tabs&) noexcept;
          LANGULUS_API(LOGGER) ScopedTabs operator << (Tabs&&) noexcept;
+         LANGULUS_API(LOGGER) Interface& operator << (const Throttle::Note&) noexcept;
 
          Interface& operator << (const CT::Sparse auto&) noexcept;
          template<class T, size_t N>
          Interface& operator << (const ::std::array<T, N>&) noexcept;
          Interface& operator << (const ::Langulus::Logger::Formattable auto&) noexcept;
          Interface& operator << (const char8_t&) noexcept;
+         template<class...T>
+         Interface& operator << (const Formatted<T...>&) noexcept;
+      };
+
+      ///                                                                     
+      /// An attachment, that receives whole lines, instead of a call for     
+      /// each fragment. Each record carries the time, intent and tabs of its 
+      /// line, so there's no need to ask the logger for them. The logger     
+      /// assembles the lines, and delivers them in batches - at the end of   
+      /// each statement, or when the async worker runs out of work.          
+      /// Fragments, that still arrive one by one (i.e. through a QueuedSink) 
+      /// are assembled here, and each line is delivered once the next one    
+      /// begins, or on Flush                                                 
+      ///                                                                     
+      struct RecordSink : Interface {
+      private:
+         ::std::unique_ptr<Inner::Lines> mLines;
+
+      public:
+         LANGULUS_API(LOGGER)  RecordSink();
+         LANGULUS_API(LOGGER) ~RecordSink();
+
+         /// Receive a batch of records                                       
+         ///   @attention records are valid only for the duration of the call 
+         virtual void WriteRecords(::std::span<const LogRecord>) const noexcept = 0;
+
+         /// Get the attachment as a record sink                              
+         const RecordSink* GetRecordSink() const noexcept final {
+            return this;
+         }
+
+         LANGULUS_API(LOGGER) void Write(const TextView&) const noexcept final;
+         LANGULUS_API(LOGGER) void Write(Style) const noexcept final;
+         LANGULUS_API(LOGGER) void NewLine() const noexcept final;
+         LANGULUS_API(LOGGER) void Flush() const noexcept;
       };
 
    } // namespace Langulus::Logger::A
@@ -365,24 +810,60 @@ namespace Langulus::Logger
    ///   The main logger interface                                            
    ///                                                                        
    /// Supports colors, formatting commands, and can relay messages to a      
-   /// list of attachments                                                    
+   /// list of attachments. The style stack, tabulation and current intent    
+   /// are kept separately for each thread                                    
    ///                                                                        
    class Interface final : public A::Interface {
    private:
-      // Color stack                                                    
-      ::std::stack<Style> mStyleStack;
-      // Number of tabulations                                          
-      size_t mTabulator = 0;
-
-      // Redirectors                                                    
-      ::std::list<A::Interface*> mRedirectors;
-      // Duplicators                                                    
-      ::std::list<A::Interface*> mDuplicators;
+      friend struct ScopedBatch;
+      friend struct Inner::CrashHandler;
+      friend struct Inner::RepeatsGuard;
+
+      struct Reading;
+
+      // Redirectors and duplicators, published as an immutable snapshot
+      // that is replaced as a whole on attaching or dettaching         
+      ::std::atomic<const Inner::Attachments*> mAttachments {};
+      // Dispatches in progress, counted for the current and previous   
+      // generation of the snapshot, so that replaced snapshots are     
+      // deleted only after nothing reads them anymore                  
+      mutable ::std::atomic<size_t> mReaders[2] {};
+      ::std::atomic<size_t> mGeneration {};
+
+      // Background worker, created the first time async mode is enabled
+      ::std::unique_ptr<Inner::Worker> mWorker;
+      // Same as mWorker, but only while async mode is enabled          
+      ::std::atomic<Inner::Worker*> mAsync {};
+      // Intents, that are silenced at runtime, one bit for each        
+      ::std::atomic<uint32_t> mSilenced {};
+      // Ring of recent history, created the first time it is started   
+      ::std::atomic<Inner::FlightRecorder*> mFlight {};
+      // Intents, that go to the flight recorder, even if silenced      
+      ::std::atomic<uint32_t> mFlightIntents {};
+      // Without a worker, each thread dispatches its own statements, so
+      // they take turns, and attachments are never used concurrently   
+      mutable ::std::recursive_mutex mStatements;
+
+      void Enqueue(const Inner::Record&) const noexcept;
+      void Commit() const noexcept;
+      void ReleaseRepeats() const noexcept;
+      void FlushQueued() const noexcept;
+      void Release(Inner::Record*, size_t count) const noexcept;
+      void Dispatch(const Inner::Record&) const noexcept;
+      void DispatchText(const TextView&) const noexcept;
+      void DispatchStyle(Style) const noexcept;
+      void DispatchNewLine() const noexcept;
+      void DispatchClear() const noexcept;
+      void ConsoleCommit(bool endOfLine) const noexcept;
+      void ConsoleFlushNow() const noexcept;
+      void DispatchFlush() const noexcept;
+      void DeliverRecords(bool onlyWhole = false) const noexcept;
+      void Publish(const Inner::Attachments*) noexcept;
+      Inner::FlightRecorder* Recording() const noexcept;
+      void CheckFlightRecorder() const noexcept;
+      void Salvage() const noexcept;
 
    public:
-      // Current intent                                                 
-      Intent CurrentIntent = Intent::Info;
-
       // Intent style customization point                               
       IntentProperties IntentStyle[int(Intent::Counter)] = {
          {"F", fmt::fg(fmt::terminal_color::red)},             // FatalError  
@@ -405,7 +886,32 @@ namespace Langulus::Logger
       Style TimeStampStyle = TabStyle;
       TextView TabString = "|  ";
 
-      size_t GetTabs() const noexcept { return mTabulator; }
+      // Timestamp customization                                        
+      Precision TimeStampPrecision = Precision::Seconds;
+
+      // Console flushing customization                                 
+      FlushPolicy ConsoleFlush;
+
+      // Number of records the async queue can hold                     
+      size_t AsyncQueueSize = 8192;
+
+      // Hold back statements, that repeat the previous one, and replace
+      // them with a single line, telling how many times it repeated.   
+      // That line is written when a different statement is logged, on  
+      // Flush, when the thread that repeated it ends, or when          
+      // RepeatTimeout passes during the repeats - in async mode, the   
+      // worker checks the timeout even if nothing else is logged       
+      ::std::atomic<bool> SuppressRepeats = false;
+      ::std::chrono::milliseconds RepeatTimeout {1000};
+
+      // Where the flight recorder is dumped, as a binary log, when a   
+      // fatal error is logged, or when its signal is raised            
+      ::std::string FlightRecorderFile = "flight.lgb";
+
+      LANGULUS_API(LOGGER) size_t GetTabs() const noexcept;
+      LANGULUS_API(LOGGER) Intent GetIntent() const noexcept;
+      LANGULUS_API(LOGGER) void   SetIntent(Intent) noexcept;
+      LANGULUS_API(LOGGER) TimePoint GetLineTime() const noexcept;
 
       LANGULUS_API(LOGGER)  Interface();
       LANGULUS_API(LOGGER)  Interface(const Interface&);
@@ -416,6 +922,7 @@ namespace Langulus::Logger
       ///                                                                     
       LANGULUS_API(LOGGER) void Write(const TextView&) const noexcept;
       LANGULUS_API(LOGGER) void Write(Style) const noexcept;
+      LANGULUS_API(LOGGER) void WriteDeferred(Inner::Formatter, const void*, size_t) const noexcept;
       LANGULUS_API(LOGGER) void NewLine() const noexcept;
       LANGULUS_API(LOGGER) void Clear() const noexcept;
 
@@ -431,11 +938,34 @@ namespace Langulus::Logger
       ///                                                                     
       /// Attachments                                                         
       ///                                                                     
-      LANGULUS_API(LOGGER) void AttachDuplicator(A::Interface*) noexcept;
+      LANGULUS_API(LOGGER) void AttachDuplicator(A::Interface*, IntentMask = {}) noexcept;
       LANGULUS_API(LOGGER) void DettachDuplicator(A::Interface*) noexcept;
 
-      LANGULUS_API(LOGGER) void AttachRedirector(A::Interface*) noexcept;
+      LANGULUS_API(LOGGER) void AttachRedirector(A::Interface*, IntentMask = {}) noexcept;
       LANGULUS_API(LOGGER) void DettachRedirector(A::Interface*) noexcept;
+
+      ///                                                                     
+      /// Asynchronous mode                                                   
+      ///                                                                     
+      LANGULUS_API(LOGGER) void SetAsync(bool) noexcept;
+      LANGULUS_API(LOGGER) bool IsAsync() const noexcept;
+      LANGULUS_API(LOGGER) void Flush() const noexcept;
+
+      ///                                                                     
+      /// Runtime intent silencing                                            
+      ///                                                                     
+      LANGULUS_API(LOGGER) void Silence(Intent) noexcept;
+      LANGULUS_API(LOGGER) void Unsilence(Intent) noexcept;
+      NOD() bool IsSilenced(Intent) const noexcept;
+
+      ///                                                                     
+      /// Flight recorder                                                     
+      ///                                                                     
+      LANGULUS_API(LOGGER) void StartFlightRecorder(size_t bytes = 4 * 1024 * 1024, IntentMask = Intent::FatalError | Intent::Error | Intent::Warning) noexcept;
+      LANGULUS_API(LOGGER) void StopFlightRecorder() noexcept;
+      LANGULUS_API(LOGGER) void SetFlightRecorderSignal(int) noexcept;
+      LANGULUS_API(LOGGER) size_t DumpFlightRecorder(const A::Interface&) const noexcept;
+      LANGULUS_API(LOGGER) size_t DumpFlightRecorder(const TextView&) const noexcept;
    };
 
 
@@ -512,12 +1042,26 @@ namespace Langulus::Logger
    template<class...T>
    NOD() ScopedTabs PromptTab(T&&...) noexcept;
 
-   LANGULUS_API(LOGGER) void AttachDuplicator(A::Interface*) noexcept;
+   LANGULUS_API(LOGGER) void AttachDuplicator(A::Interface*, IntentMask = {}) noexcept;
    LANGULUS_API(LOGGER) void DettachDuplicator(A::Interface*) noexcept;
 
-   LANGULUS_API(LOGGER) void AttachRedirector(A::Interface*) noexcept;
+   LANGULUS_API(LOGGER) void AttachRedirector(A::Interface*, IntentMask = {}) noexcept;
    LANGULUS_API(LOGGER) void DettachRedirector(A::Interface*) noexcept;
 
+   LANGULUS_API(LOGGER) void SetAsync(bool) noexcept;
+   LANGULUS_API(LOGGER) void Flush() noexcept;
+
+   LANGULUS_API(LOGGER) void Silence(Intent) noexcept;
+   LANGULUS_API(LOGGER) void Unsilence(Intent) noexcept;
+
+   LANGULUS_API(LOGGER) size_t EnableCallSites(bool, const TextView& file, uint32_t line = 0) noexcept;
+
+   LANGULUS_API(LOGGER) void StartFlightRecorder(size_t bytes = 4 * 1024 * 1024, IntentMask = Intent::FatalError | Intent::Error | Intent::Warning) noexcept;
+   LANGULUS_API(LOGGER) size_t DumpFlightRecorder(const TextView&) noexcept;
+
+   LANGULUS_API(LOGGER) void InstallCrashHandler(::std::chrono::milliseconds budget = ::std::chrono::milliseconds {200}) noexcept;
+   LANGULUS_API(LOGGER) void UninstallCrashHandler() noexcept;
+
 
    ///                                                                        
    /// Helpful redirectors and duplicators                                    
@@ -544,7 +1088,8 @@ namespace Langulus::Logger
    ///                                                                        
    /// Generates HTML code from logging messages. Can be used both as         
    /// duplicator or redirector. Colors and styles are consistent with        
-   /// console output. Use it like this:                                      
+   /// console output, and are written as classes from a stylesheet in the    
+   /// header, only when the style actually changes. Use it like this:        
    ///    Logger::ToHTML logRedirect("outputfile.htm");                       
    ///    Logger::AttachRedirector(&logRedirect);                             
    ///    <redirect all logging to an HTML file>                              
@@ -553,20 +1098,28 @@ namespace Langulus::Logger
    ///                                                                        
    struct ToHTML final : Logger::A::Interface {
    private:
-      std::string mFilename;
-      mutable std::ofstream mFile;
+      ::std::unique_ptr<Inner::FileWriter> mFile;
+
+      // The requested style, and the style of the span that is open    
+      mutable Style mStyle;
+      mutable Style mOpenStyle;
+      mutable bool mStylePending = false;
+      mutable bool mStyleOpen = false;
 
       void WriteHeader() const;
       void WriteFooter() const;
+      void OpenStyle() const noexcept;
+      void CloseStyle() const noexcept;
 
    public:
-      LANGULUS_API(LOGGER)  ToHTML(const TextView&);
+      LANGULUS_API(LOGGER)  ToHTML(const TextView&, const FilePolicy& = {});
       LANGULUS_API(LOGGER) ~ToHTML();
 
       LANGULUS_API(LOGGER) void Write(const TextView&) const noexcept;
       LANGULUS_API(LOGGER) void Write(Style) const noexcept;
       LANGULUS_API(LOGGER) void NewLine() const noexcept;
       LANGULUS_API(LOGGER) void Clear() const noexcept;
+      LANGULUS_API(LOGGER) void Flush() const noexcept;
    };
 
    ///                                                                        
@@ -580,20 +1133,136 @@ namespace Langulus::Logger
    ///                                                                        
    struct ToTXT final : Logger::A::Interface {
    private:
-      std::string mFilename;
-      mutable std::ofstream mFile;
+      ::std::unique_ptr<Inner::FileWriter> mFile;
 
       void WriteHeader() const;
       void WriteFooter() const;
 
    public:
-      LANGULUS_API(LOGGER)  ToTXT(const TextView&);
+      LANGULUS_API(LOGGER)  ToTXT(const TextView&, const FilePolicy& = {});
       LANGULUS_API(LOGGER) ~ToTXT();
 
       LANGULUS_API(LOGGER) void Write(const TextView&) const noexcept;
       LANGULUS_API(LOGGER) void Write(Style) const noexcept;
       LANGULUS_API(LOGGER) void NewLine() const noexcept;
       LANGULUS_API(LOGGER) void Clear() const noexcept;
+      LANGULUS_API(LOGGER) void Flush() const noexcept;
+   };
+
+   ///                                                                        
+   /// Generates plain text file from logging messages, just like ToTXT, but  
+   /// writes by copying into a memory-mapped file. The file grows by         
+   /// FilePolicy::preallocate bytes at a time, and the system writes pages   
+   /// back on its own, so everything logged survives a crash of the process. 
+   /// Until the file is closed, its end is padded with zeroes, and it stays  
+   /// that way after a crash, so read it up to the first zero byte           
+   ///                                                                        
+   struct ToMappedTXT final : Logger::A::Interface {
+   private:
+      ::std::unique_ptr<Inner::MappedFile> mFile;
+
+      void WriteHeader() const;
+      void WriteFooter() const;
+
+   public:
+      LANGULUS_API(LOGGER)  ToMappedTXT(const TextView&, const FilePolicy& = {});
+      LANGULUS_API(LOGGER) ~ToMappedTXT();
+
+      LANGULUS_API(LOGGER) void Write(const TextView&) const noexcept;
+      LANGULUS_API(LOGGER) void Write(Style) const noexcept;
+      LANGULUS_API(LOGGER) void NewLine() const noexcept;
+      LANGULUS_API(LOGGER) void Clear() const noexcept;
+      LANGULUS_API(LOGGER) void Flush() const noexcept;
+   };
+
+   ///                                                                        
+   /// Writes logging messages as compact binary records, instead of text.    
+   /// Each record is checksummed, and holds the time, intent, tabs and style 
+   /// of the text, so rendering is done later, by DecodeBinary. Use it like: 
+   ///    Logger::ToBinary logRedirect("outputfile.lgb");                     
+   ///    Logger::AttachRedirector(&logRedirect);                             
+   ///    <redirect all logging to a binary file>                             
+   ///    Logger::DettachRedirector(&logRedirect);                            
+   ///    ...                                                                 
+   ///    Logger::ToTXT decoded("outputfile.txt");                            
+   ///    Logger::DecodeBinary("outputfile.lgb", decoded);                    
+   ///                                                                        
+   struct ToBinary final : Logger::A::Interface {
+   private:
+      ::std::unique_ptr<Inner::BinaryWriter> mWriter;
+
+   public:
+      LANGULUS_API(LOGGER)  ToBinary(const TextView&, const FilePolicy& = {});
+      LANGULUS_API(LOGGER) ~ToBinary();
+
+      LANGULUS_API(LOGGER) void Write(const TextView&) const noexcept;
+      LANGULUS_API(LOGGER) void Write(Style) const noexcept;
+      LANGULUS_API(LOGGER) void NewLine() const noexcept;
+      LANGULUS_API(LOGGER) void Clear() const noexcept;
+      LANGULUS_API(LOGGER) void Flush() const noexcept;
+   };
+
+   LANGULUS_API(LOGGER) size_t DecodeBinary(const TextView&, const A::Interface&);
+
+   /// State of a QueuedSink's queue, at the time it was requested            
+   struct SinkStatistics {
+      // Records waiting in the queue, and the most it can hold         
+      size_t pending = 0;
+      size_t capacity = 0;
+      // Records written to the sink so far                             
+      size_t dispatched = 0;
+      // Records dropped, because the queue was full                    
+      size_t dropped = 0;
+      // How long ago the line, that the sink last started, was logged, 
+      // and the most that has ever been                                
+      ::std::chrono::nanoseconds lag {};
+      ::std::chrono::nanoseconds maxLag {};
+   };
+
+   ///                                                                        
+   /// Gives an attachment its own queue and background thread, so that a     
+   /// slow attachment doesn't hold up the console, the other attachments,    
+   /// or the threads that log. Wrap any attachment, and attach the wrapper:  
+   ///    Logger::ToHTML logFile("outputfile.htm");                           
+   ///    Logger::QueuedSink queued(logFile);                                 
+   ///    Logger::AttachDuplicator(&queued);                                  
+   ///    <the file is written by its own thread>                             
+   ///    Logger::DettachDuplicator(&queued);                                 
+   /// When the queue is full, the rest of the line is dropped by default,    
+   /// instead of waiting for the attachment to catch up                      
+   ///                                                                        
+   struct QueuedSink final : Logger::A::Interface {
+      enum Overflow : uint8_t {
+         Drop,       // Drop lines that don't fit, and count them
+         Block       // Wait until there is room
+      };
+
+   private:
+      const A::Interface& mSink;
+      const Overflow mOverflow;
+      ::std::unique_ptr<Inner::Worker> mWorker;
+
+      // Set when a record was dropped, so that the rest of the line is 
+      // dropped, too                                                   
+      mutable ::std::atomic<bool> mDropping {false};
+      mutable ::std::atomic<size_t> mDropped {0};
+      mutable ::std::atomic<int64_t> mLag {0};
+      mutable ::std::atomic<int64_t> mMaxLag {0};
+
+      void Push(const Inner::Record*, size_t count) const noexcept;
+      void Dispatch(const Inner::Record&) const noexcept;
+
+   public:
+      LANGULUS_API(LOGGER)  QueuedSink(const A::Interface&, size_t capacity = 8192, Overflow = Drop);
+      LANGULUS_API(LOGGER) ~QueuedSink();
+
+      LANGULUS_API(LOGGER) void Write(const TextView&) const noexcept;
+      LANGULUS_API(LOGGER) void Write(Style) const noexcept;
+      LANGULUS_API(LOGGER) void NewLine() const noexcept;
+      LANGULUS_API(LOGGER) void Clear() const noexcept;
+      LANGULUS_API(LOGGER) void Flush() const noexcept;
+
+      NOD() LANGULUS_API(LOGGER) SinkStatistics GetStatistics() const noexcept;
    };
 
    /// Generate hexadecimal string from a given value                         
@@ -614,6 +1283,56 @@ namespace Langulus::Logger
 #define LANGULUS_FUNCTION_NAME() \
    (::Langulus::Logger::A::Interface::GetFunctionName(LANGULUS_FUNCTION()))
 
+/// Log through one of the logging functions, like Verbose or Network, only   
+/// every Nth time this call site is reached. Skipped statements don't even   
+/// evaluate their arguments, and the next logged line tells how many were    
+/// skipped - or Flush does, if no line is logged from there anymore. Call    
+/// sites of intents, that are compiled out, don't count anything:            
+///    LANGULUS_LOG_EVERY(100, Network, "Received packet ", id);              
+#define LANGULUS_LOG_EVERY(n, function, ...) \
+   LANGULUS_LOG_THROTTLED(::Langulus::Logger::Sampling, n, function, __VA_ARGS__)
+
+/// Log through one of the logging functions at most K times per second from  
+/// this call site, otherwise the same as LANGULUS_LOG_EVERY:                 
+///    LANGULUS_LOG_RATE(10, Network, "Received packet ", id);                
+#define LANGULUS_LOG_RATE(perSecond, function, ...) \
+   LANGULUS_LOG_THROTTLED(::Langulus::Logger::RateLimit, perSecond, function, __VA_ARGS__)
+
+/// Log through one of the logging functions, like Verbose or Network, from   
+/// a call site that is registered before main, and can be switched off at    
+/// runtime:                                                                  
+///    LANGULUS_LOG(Network, "Received packet ", id);                         
+///    Logger::EnableCallSites(false, "Network.cpp");                         
+#define LANGULUS_LOG(function, ...) \
+   do { \
+      static constexpr ::Langulus::Logger::TextView langulusFunction = \
+         LANGULUS_FUNCTION_NAME(); \
+      struct LangulusCallSite { \
+         static ::Langulus::Logger::CallSite Make() noexcept { \
+            return {__FILE__, __LINE__, langulusFunction, \
+               ::Langulus::Logger::CallSite::IntentOf(#function), #__VA_ARGS__}; \
+         } \
+      }; \
+      auto& langulusCallSite = \
+         ::Langulus::Logger::StaticCallSite<LangulusCallSite>::site; \
+      if (langulusCallSite.IsEnabled()) \
+         ::Langulus::Logger::function(__VA_ARGS__); \
+   } while (false)
+
+#define LANGULUS_LOG_THROTTLED(throttle, limit, function, ...) \
+   do { \
+      constexpr auto langulusIntent = \
+         ::Langulus::Logger::CallSite::IntentOf(#function); \
+      if constexpr (::Langulus::Logger::IsCompiledIn(langulusIntent)) { \
+         static throttle langulusCallSite {limit, __FILE__, __LINE__, langulusIntent}; \
+         if (langulusCallSite.Pass()) { \
+            const ::Langulus::Logger::ScopedBatch langulusBatch; \
+            [[maybe_unused]] auto&& langulusResult = ::Langulus::Logger::function(__VA_ARGS__); \
+            ::Langulus::Logger::Append(langulusCallSite.Skipped()); \
+         } \
+      } \
+   } while (false)
+
 #include "Logger.inl"
 
 namespace fmt
@@ -94,21 +94,115 @@ namespace Langulus::Logger
    }
 
    /// Stringify anything that has a valid fmt formatter                      
+   /// Booleans and characters never touch fmt's format machinery. Numbers,   
+   /// enums and other types that allow deferred formatting are just copied   
+   /// in async mode, and formatted later, by the background thread. Anything 
+   /// else is formatted into a stack buffer, which only allocates if the     
+   /// result is longer than fmt::inline_buffer_size                          
    ///   @param anything - type to stringify                                  
    ///   @return a reference to the logger for chaining                       
    LANGULUS(INLINED)
    A::Interface& A::Interface::operator << (const Formattable auto& anything) noexcept {
-      const auto formatted = fmt::format("{}", anything);
-      return operator << (TextView {formatted});
+      using T = Deref<decltype(anything)>;
+      if constexpr (::std::same_as<T, bool>)
+         return operator << (anything ? TextView {"true"} : TextView {"false"});
+      else if constexpr (::std::same_as<T, Letter>)
+         return operator << (TextView {&anything, 1});
+      else if constexpr (Inner::Deferrable<T>) {
+         Instance.WriteDeferred(&Inner::FormatDeferred<T>, &anything, sizeof(T));
+         return *this;
+      }
+      else {
+         ::fmt::memory_buffer formatted;
+         ::fmt::format_to(::std::back_inserter(formatted), "{}", anything);
+         return operator << (TextView {formatted.data(), formatted.size()});
+      }
    }
    
+   /// Format a value from a copy of its bytes                                
+   ///   @tparam T - the type of the value                                    
+   ///   @param data - the bytes of the value                                 
+   ///   @param to - the buffer to format into                                
+   template<class T>
+   void Inner::FormatDeferred(const void* data, ::fmt::memory_buffer& to) noexcept {
+      ::std::array<::std::byte, sizeof(T)> bytes;
+      ::std::memcpy(bytes.data(), data, sizeof(T));
+      const auto value = ::std::bit_cast<T>(bytes);
+
+      if constexpr (::std::is_integral_v<T> and not ::std::same_as<T, bool>
+                                            and not ::std::same_as<T, Letter>) {
+         const ::fmt::format_int formatted {value};
+         to.append(formatted.data(), formatted.data() + formatted.size());
+      }
+      else {
+         try { ::fmt::format_to(::std::back_inserter(to), "{}", value); }
+         catch (...) {}
+      }
+   }
+
    /// Stringify char8_t                                                      
    ///   @param c - char                                                      
    ///   @return a reference to the logger for chaining                       
    LANGULUS(INLINED)
    A::Interface& A::Interface::operator << (const char8_t& c) noexcept {
-      const auto formatted = fmt::format("{}", reinterpret_cast<const char&>(c));
-      return operator << (TextView {formatted});
+      return operator << (TextView {reinterpret_cast<const Letter*>(&c), 1});
+   }
+
+   /// Render a message from a compile-time checked format string, and write  
+   /// it in one piece. If rendering fails at runtime, for example because    
+   /// of a dynamic width that is out of range, the format string is written  
+   /// instead, after a marker                                                
+   ///   @param message - the message to render                               
+   ///   @return a reference to the logger for chaining                       
+   template<class...T> LANGULUS(INLINED)
+   A::Interface& A::Interface::operator << (const Formatted<T...>& message) noexcept {
+      ::fmt::memory_buffer rendered;
+      try {
+         ::std::apply([&](const auto&...arguments) {
+            ::fmt::vformat_to(::std::back_inserter(rendered), ::fmt::string_view {message.mFormat},
+               ::fmt::make_format_args(arguments...));
+         }, message.mArguments);
+      }
+      catch (...) {
+         const ::fmt::string_view format {message.mFormat};
+         operator << (TextView {"<format error> "});
+         return operator << (TextView {format.data(), format.size()});
+      }
+      return operator << (TextView {rendered.data(), rendered.size()});
+   }
+
+   /// Check if an intent is silenced at runtime                              
+   ///   @param i - the intent to check                                       
+   ///   @return true if statements with that intent are ignored              
+   LANGULUS(INLINED)
+   bool Interface::IsSilenced(Intent i) const noexcept {
+      // Silenced intents are still formatted for the flight recorder   
+      const auto silenced = mSilenced.load(::std::memory_order_relaxed)
+         & ~mFlightIntents.load(::std::memory_order_relaxed);
+      return i < Intent::Counter and (silenced & (1u << int(i)));
+   }
+
+   namespace Inner
+   {
+      /// Ignore a silenced statement, without formatting any arguments       
+      ///   @tparam ...T - the statement's arguments                          
+      ///   @return the same as what the statement would return               
+      template<class...T> LANGULUS(INLINED)
+      decltype(auto) Ignore() noexcept {
+         if constexpr (sizeof...(T) > 0) {
+            // A trailing Logger::Tabs{} makes the statement scoped     
+            using R = decltype((Instance << ... << ::std::declval<T>()));
+            if constexpr (::std::same_as<R, ScopedTabs>) {
+               Instance << Intent::Ignore;
+               return ScopedTabs {0};
+            }
+            else return (Instance << Intent::Ignore);
+         }
+         else {
+            Instance << Intent::Ignore;
+            return (Instance);
+         }
+      }
    }
 
    /// A general new-line write function that continues the last intent/style 
@@ -116,6 +210,11 @@ namespace Langulus::Logger
    ///   @return a reference to the logger for chaining                       
    template<class...T> LANGULUS(INLINED)
    decltype(auto) Line(T&&...arguments) noexcept {
+      // Continuation of an ignored statement is ignored, too           
+      if (Instance.GetIntent() == Intent::Ignore)
+         return Inner::Ignore<T...>();
+
+      const ScopedBatch batch;
       Instance.NewLine();
 
       if constexpr (sizeof...(arguments) > 0)
@@ -129,8 +228,14 @@ namespace Langulus::Logger
    ///   @return a reference to the logger for chaining                       
    template<class...T> LANGULUS(INLINED)
    decltype(auto) Append(T&&...arguments) noexcept {
-      if constexpr (sizeof...(arguments) > 0)
+      if constexpr (sizeof...(arguments) > 0) {
+         // Continuation of an ignored statement is ignored, too        
+         if (Instance.GetIntent() == Intent::Ignore)
+            return (Instance);
+
+         const ScopedBatch batch;
          (Instance << ... << ::std::forward<T>(arguments));
+      }
       return (Instance);
    }
 
@@ -142,6 +247,7 @@ namespace Langulus::Logger
    template<class...T> LANGULUS(INLINED)
    decltype(auto) Section(T&&...arguments) noexcept {
       if constexpr (sizeof...(arguments) > 0) {
+         const ScopedBatch batch;
          const auto currentStyle = Instance.GetCurrentStyle();
          Instance.NewLine();
          Instance << Command::Push
@@ -154,12 +260,63 @@ namespace Langulus::Logger
       else return (Instance);
    }
 
+   /// Check if the logging function of an intent is compiled in, by the      
+   /// LANGULUS_LOGGER_ENABLE_* switches. Throttled call sites of functions,  
+   /// that aren't, neither count nor report their skips                      
+   ///   @param intent - the intent to check                                  
+   ///   @return true if statements of the intent can be logged at all        
+   constexpr bool IsCompiledIn([[maybe_unused]] Intent intent) noexcept {
+      switch (intent) {
+      #ifndef LANGULUS_LOGGER_ENABLE_FATALERRORS
+         case Intent::FatalError: return false;
+      #endif
+      #ifndef LANGULUS_LOGGER_ENABLE_ERRORS
+         case Intent::Error: return false;
+      #endif
+      #ifndef LANGULUS_LOGGER_ENABLE_WARNINGS
+         case Intent::Warning: return false;
+      #endif
+      #ifndef LANGULUS_LOGGER_ENABLE_VERBOSE
+         case Intent::Verbose: return false;
+      #endif
+      #ifndef LANGULUS_LOGGER_ENABLE_INFOS
+         case Intent::Info: return false;
+      #endif
+      #ifndef LANGULUS_LOGGER_ENABLE_MESSAGES
+         case Intent::Message: return false;
+      #endif
+      #ifndef LANGULUS_LOGGER_ENABLE_SPECIALS
+         case Intent::Special: return false;
+      #endif
+      #ifndef LANGULUS_LOGGER_ENABLE_FLOWS
+         case Intent::Flow: return false;
+      #endif
+      #ifndef LANGULUS_LOGGER_ENABLE_INPUTS
+         case Intent::Input: return false;
+      #endif
+      #ifndef LANGULUS_LOGGER_ENABLE_NETWORKS
+         case Intent::Network: return false;
+      #endif
+      #ifndef LANGULUS_LOGGER_ENABLE_OS
+         case Intent::OS: return false;
+      #endif
+      #ifndef LANGULUS_LOGGER_ENABLE_PROMPTS
+         case Intent::Prompt: return false;
+      #endif
+      default: return true;
+      }
+   }
+
    /// Write a new-line fatal error                                           
    ///   @tparam ...T - a sequence of elements to log (deducible)             
    ///   @return a reference to the logger for chaining                       
    template<class...T> LANGULUS(INLINED)
    decltype(auto) Fatal([[maybe_unused]] T&&...arguments) noexcept {
       #ifdef LANGULUS_LOGGER_ENABLE_FATALERRORS
+         if (Instance.IsSilenced(Intent::FatalError))
+            return Inner::Ignore<T...>();
+
+         const ScopedBatch batch;
          Instance << Intent::FatalError;
          Instance.NewLine();
 
@@ -179,6 +336,11 @@ namespace Langulus::Logger
    template<class...T> LANGULUS(INLINED)
    ScopedTabs FatalTab([[maybe_unused]] T&&...arguments) noexcept {
       #ifdef LANGULUS_LOGGER_ENABLE_FATALERRORS
+         if (Instance.IsSilenced(Intent::FatalError)) {
+            Instance << Intent::Ignore;
+            return ScopedTabs {0};
+         }
+
          Fatal(::std::forward<T>(arguments)...);
          return (Instance << Tabs {});
       #else
@@ -193,6 +355,10 @@ namespace Langulus::Logger
    template<class...T> LANGULUS(INLINED)
    decltype(auto) Error([[maybe_unused]] T&&...arguments) noexcept {
       #ifdef LANGULUS_LOGGER_ENABLE_ERRORS
+         if (Instance.IsSilenced(Intent::Error))
+            return Inner::Ignore<T...>();
+
+         const ScopedBatch batch;
          Instance << Intent::Error;
          Instance.NewLine();
 
@@ -212,6 +378,11 @@ namespace Langulus::Logger
    template<class...T> LANGULUS(INLINED)
    ScopedTabs ErrorTab([[maybe_unused]] T&&...arguments) noexcept {
       #ifdef LANGULUS_LOGGER_ENABLE_ERRORS
+         if (Instance.IsSilenced(Intent::Error)) {
+            Instance << Intent::Ignore;
+            return ScopedTabs {0};
+         }
+
          Error(::std::forward<T>(arguments)...);
          return (Instance << Tabs {});
       #else
@@ -226,6 +397,10 @@ namespace Langulus::Logger
    template<class...T> LANGULUS(INLINED)
    decltype(auto) Warning([[maybe_unused]] T&&...arguments) noexcept {
       #ifdef LANGULUS_LOGGER_ENABLE_WARNINGS
+         if (Instance.IsSilenced(Intent::Warning))
+            return Inner::Ignore<T...>();
+
+         const ScopedBatch batch;
          Instance << Intent::Warning;
          Instance.NewLine();
 
@@ -245,6 +420,11 @@ namespace Langulus::Logger
    template<class...T> LANGULUS(INLINED)
    ScopedTabs WarningTab([[maybe_unused]] T&&...arguments) noexcept {
       #ifdef LANGULUS_LOGGER_ENABLE_WARNINGS
+         if (Instance.IsSilenced(Intent::Warning)) {
+            Instance << Intent::Ignore;
+            return ScopedTabs {0};
+         }
+
          Warning(::std::forward<T>(arguments)...);
          return (Instance << Tabs {});
       #else
@@ -259,6 +439,10 @@ namespace Langulus::Logger
    template<class...T> LANGULUS(INLINED)
    decltype(auto) Verbose([[maybe_unused]] T&&...arguments) noexcept {
       #ifdef LANGULUS_LOGGER_ENABLE_VERBOSE
+         if (Instance.IsSilenced(Intent::Verbose))
+            return Inner::Ignore<T...>();
+
+         const ScopedBatch batch;
          Instance << Intent::Verbose;
          Instance.NewLine();
 
@@ -278,6 +462,11 @@ namespace Langulus::Logger
    template<class...T> LANGULUS(INLINED)
    ScopedTabs VerboseTab([[maybe_unused]] T&&...arguments) noexcept {
       #ifdef LANGULUS_LOGGER_ENABLE_VERBOSE
+         if (Instance.IsSilenced(Intent::Verbose)) {
+            Instance << Intent::Ignore;
+            return ScopedTabs {0};
+         }
+
          Verbose(::std::forward<T>(arguments)...);
          return (Instance << Tabs {});
       #else
@@ -292,6 +481,10 @@ namespace Langulus::Logger
    template<class...T> LANGULUS(INLINED)
    decltype(auto) Info([[maybe_unused]] T&&...arguments) noexcept {
       #ifdef LANGULUS_LOGGER_ENABLE_INFOS
+         if (Instance.IsSilenced(Intent::Info))
+            return Inner::Ignore<T...>();
+
+         const ScopedBatch batch;
          Instance << Intent::Info;
          Instance.NewLine();
 
@@ -311,6 +504,11 @@ namespace Langulus::Logger
    template<class...T> LANGULUS(INLINED)
    ScopedTabs InfoTab([[maybe_unused]] T&&...arguments) noexcept {
       #ifdef LANGULUS_LOGGER_ENABLE_INFOS
+         if (Instance.IsSilenced(Intent::Info)) {
+            Instance << Intent::Ignore;
+            return ScopedTabs {0};
+         }
+
          Info(::std::forward<T>(arguments)...);
          return (Instance << Tabs {});
       #else
@@ -325,6 +523,10 @@ namespace Langulus::Logger
    template<class...T> LANGULUS(INLINED)
    decltype(auto) Message([[maybe_unused]] T&&...arguments) noexcept {
       #ifdef LANGULUS_LOGGER_ENABLE_MESSAGES
+         if (Instance.IsSilenced(Intent::Message))
+            return Inner::Ignore<T...>();
+
+         const ScopedBatch batch;
          Instance << Intent::Message;
          Instance.NewLine();
 
@@ -344,6 +546,11 @@ namespace Langulus::Logger
    template<class...T> LANGULUS(INLINED)
    ScopedTabs MessageTab([[maybe_unused]] T&&...arguments) noexcept {
       #ifdef LANGULUS_LOGGER_ENABLE_MESSAGES
+         if (Instance.IsSilenced(Intent::Message)) {
+            Instance << Intent::Ignore;
+            return ScopedTabs {0};
+         }
+
          Message(::std::forward<T>(arguments)...);
          return (Instance << Tabs {});
       #else
@@ -358,6 +565,10 @@ namespace Langulus::Logger
    template<class...T> LANGULUS(INLINED)
    decltype(auto) Special([[maybe_unused]] T&&...arguments) noexcept {
       #ifdef LANGULUS_LOGGER_ENABLE_SPECIALS
+         if (Instance.IsSilenced(Intent::Special))
+            return Inner::Ignore<T...>();
+
+         const ScopedBatch batch;
          Instance << Intent::Special;
          Instance.NewLine();
 
@@ -377,6 +588,11 @@ namespace Langulus::Logger
    template<class...T> LANGULUS(INLINED)
    ScopedTabs SpecialTab([[maybe_unused]] T&&...arguments) noexcept {
       #ifdef LANGULUS_LOGGER_ENABLE_SPECIALS
+         if (Instance.IsSilenced(Intent::Special)) {
+            Instance << Intent::Ignore;
+            return ScopedTabs {0};
+         }
+
          Special(::std::forward<T>(arguments)...);
          return (Instance << Tabs {});
       #else
@@ -391,6 +607,10 @@ namespace Langulus::Logger
    template<class...T> LANGULUS(INLINED)
    decltype(auto) Flow([[maybe_unused]] T&&...arguments) noexcept {
       #ifdef LANGULUS_LOGGER_ENABLE_FLOWS
+         if (Instance.IsSilenced(Intent::Flow))
+            return Inner::Ignore<T...>();
+
+         const ScopedBatch batch;
          Instance << Intent::Flow;
          Instance.NewLine();
 
@@ -410,6 +630,11 @@ namespace Langulus::Logger
    template<class...T> LANGULUS(INLINED)
    ScopedTabs FlowTab([[maybe_unused]] T&&...arguments) noexcept {
       #ifdef LANGULUS_LOGGER_ENABLE_FLOWS
+         if (Instance.IsSilenced(Intent::Flow)) {
+            Instance << Intent::Ignore;
+            return ScopedTabs {0};
+         }
+
          Flow(::std::forward<T>(arguments)...);
          return (Instance << Tabs {});
       #else
@@ -424,6 +649,10 @@ namespace Langulus::Logger
    template<class...T> LANGULUS(INLINED)
    decltype(auto) Input([[maybe_unused]] T&&...arguments) noexcept {
       #ifdef LANGULUS_LOGGER_ENABLE_INPUTS
+         if (Instance.IsSilenced(Intent::Input))
+            return Inner::Ignore<T...>();
+
+         const ScopedBatch batch;
          Instance << Intent::Input;
          Instance.NewLine();
 
@@ -443,6 +672,11 @@ namespace Langulus::Logger
    template<class...T> LANGULUS(INLINED)
    ScopedTabs InputTab([[maybe_unused]] T&&...arguments) noexcept {
       #ifdef LANGULUS_LOGGER_ENABLE_INPUTS
+         if (Instance.IsSilenced(Intent::Input)) {
+            Instance << Intent::Ignore;
+            return ScopedTabs {0};
+         }
+
          Input(::std::forward<T>(arguments)...);
          return (Instance << Tabs {});
       #else
@@ -457,6 +691,10 @@ namespace Langulus::Logger
    template<class...T> LANGULUS(INLINED)
    decltype(auto) Network([[maybe_unused]] T&&...arguments) noexcept {
       #ifdef LANGULUS_LOGGER_ENABLE_NETWORKS
+         if (Instance.IsSilenced(Intent::Network))
+            return Inner::Ignore<T...>();
+
+         const ScopedBatch batch;
          Instance << Intent::Network;
          Instance.NewLine();
 
@@ -476,6 +714,11 @@ namespace Langulus::Logger
    template<class...T> LANGULUS(INLINED)
    ScopedTabs NetworkTab([[maybe_unused]] T&&...arguments) noexcept {
       #ifdef LANGULUS_LOGGER_ENABLE_NETWORKS
+         if (Instance.IsSilenced(Intent::Network)) {
+            Instance << Intent::Ignore;
+            return ScopedTabs {0};
+         }
+
          Network(::std::forward<T>(arguments)...);
          return (Instance << Tabs {});
       #else
@@ -490,6 +733,10 @@ namespace Langulus::Logger
    template<class...T> LANGULUS(INLINED)
    decltype(auto) OS([[maybe_unused]] T&&...arguments) noexcept {
       #ifdef LANGULUS_LOGGER_ENABLE_OS
+         if (Instance.IsSilenced(Intent::OS))
+            return Inner::Ignore<T...>();
+
+         const ScopedBatch batch;
          Instance << Intent::OS;
          Instance.NewLine();
 
@@ -509,6 +756,11 @@ namespace Langulus::Logger
    template<class...T> LANGULUS(INLINED)
    ScopedTabs OSTab([[maybe_unused]] T&&...arguments) noexcept {
       #ifdef LANGULUS_LOGGER_ENABLE_OS
+         if (Instance.IsSilenced(Intent::OS)) {
+            Instance << Intent::Ignore;
+            return ScopedTabs {0};
+         }
+
          OS(::std::forward<T>(arguments)...);
          return (Instance << Tabs {});
       #else
@@ -523,6 +775,10 @@ namespace Langulus::Logger
    template<class...T> LANGULUS(INLINED)
    decltype(auto) Prompt([[maybe_unused]] T&&...arguments) noexcept {
       #ifdef LANGULUS_LOGGER_ENABLE_PROMPTS
+         if (Instance.IsSilenced(Intent::Prompt))
+            return Inner::Ignore<T...>();
+
+         const ScopedBatch batch;
          Instance << Intent::Prompt;
          Instance.NewLine();
 
@@ -542,6 +798,11 @@ namespace Langulus::Logger
    template<class...T> LANGULUS(INLINED)
    ScopedTabs PromptTab([[maybe_unused]] T&&...arguments) noexcept {
       #ifdef LANGULUS_LOGGER_ENABLE_PROMPTS
+         if (Instance.IsSilenced(Intent::Prompt)) {
+            Instance << Intent::Ignore;
+            return ScopedTabs {0};
+         }
+
          Prompt(::std::forward<T>(arguments)...);
          return (Instance << Tabs {});
       #else
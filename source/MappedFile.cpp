@@ -0,0 +1,201 @@
+///                                                                           
+/// Langulus::Logger                                                          
+/// Copyright (c) 2012 Dimo Markov <team@langulus.com>                        
+/// Part of the Langulus framework, see https://langulus.com                  
+///                                                                           
+/// SPDX-License-Identifier: MIT                                              
+///                                                                           
+#include "MappedFile.hpp"
+#include <cstring>
+#include <stdexcept>
+
+#ifdef _WIN32
+   #define WIN32_LEAN_AND_MEAN
+   #define NOMINMAX
+   #include <windows.h>
+#else
+   #include <unistd.h>
+   #include <fcntl.h>
+   #include <sys/mman.h>
+#endif
+
+using namespace Langulus;
+using namespace Langulus::Logger;
+using namespace Langulus::Logger::Inner;
+
+/// The file grows at least by this much at a time                            
+constexpr size_t MinimumChunk = 64 * 1024;
+
+
+/// Create the file, and map its first chunk                                  
+///   @param filename - the relative filename of the log file                 
+///   @param policy - preallocate is used as the growth step, and sync        
+///      decides when written pages are forced to the disk                    
+MappedFile::MappedFile(const TextView& filename, const FilePolicy& policy)
+   : mFilename {filename}
+   , mPolicy   {policy} {
+   mPolicy.preallocate = ::std::max(mPolicy.preallocate, MinimumChunk);
+
+#ifdef _WIN32
+   const auto file = ::CreateFileA(mFilename.c_str(),
+      GENERIC_READ | GENERIC_WRITE, FILE_SHARE_READ, nullptr,
+      CREATE_ALWAYS, FILE_ATTRIBUTE_NORMAL, nullptr);
+   if (file == INVALID_HANDLE_VALUE)
+      throw std::runtime_error {"Can't open log file"};
+   mFile = file;
+#else
+   mFile = ::open(mFilename.c_str(),
+      O_RDWR | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+   if (mFile < 0)
+      throw std::runtime_error {"Can't open log file"};
+#endif
+
+   if (not Map(mPolicy.preallocate)) {
+   #ifdef _WIN32
+      ::CloseHandle(mFile);
+   #else
+      ::close(mFile);
+   #endif
+      throw std::runtime_error {"Can't map log file"};
+   }
+}
+
+/// Trim the file to the written size, and close it                           
+MappedFile::~MappedFile() {
+   if (mView and mPolicy.sync != FilePolicy::NeverSync)
+      Sync(true);
+   Unmap();
+
+#ifdef _WIN32
+   if (mFile) {
+      LARGE_INTEGER size;
+      size.QuadPart = static_cast<LONGLONG>(mUsed);
+      ::SetFilePointerEx(mFile, size, nullptr, FILE_BEGIN);
+      ::SetEndOfFile(mFile);
+      ::CloseHandle(mFile);
+      mFile = nullptr;
+   }
+#else
+   if (mFile >= 0) {
+      [[maybe_unused]] auto result = ::ftruncate(mFile, static_cast<off_t>(mUsed));
+      ::close(mFile);
+      mFile = -1;
+   }
+#endif
+}
+
+/// Resize the file, and map all of it                                        
+///   @param capacity - the new size of the file, in bytes                    
+///   @return true if the file was mapped                                     
+bool MappedFile::Map(size_t capacity) noexcept {
+   Unmap();
+
+#ifdef _WIN32
+   LARGE_INTEGER size;
+   size.QuadPart = static_cast<LONGLONG>(capacity);
+   mMapping = ::CreateFileMappingA(mFile, nullptr, PAGE_READWRITE,
+      size.HighPart, size.LowPart, nullptr);
+   if (not mMapping)
+      return false;
+
+   mView = static_cast<Letter*>(::MapViewOfFile(
+      mMapping, FILE_MAP_WRITE, 0, 0, capacity));
+   if (not mView) {
+      ::CloseHandle(mMapping);
+      mMapping = nullptr;
+      return false;
+   }
+#else
+   if (::ftruncate(mFile, static_cast<off_t>(capacity)) != 0)
+      return false;
+
+   const auto view = ::mmap(nullptr, capacity,
+      PROT_READ | PROT_WRITE, MAP_SHARED, mFile, 0);
+   if (view == MAP_FAILED)
+      return false;
+   mView = static_cast<Letter*>(view);
+#endif
+
+   mCapacity = capacity;
+   return true;
+}
+
+/// Release the mapping, pages are still written back by the system           
+void MappedFile::Unmap() noexcept {
+   if (not mView)
+      return;
+
+#ifdef _WIN32
+   ::UnmapViewOfFile(mView);
+   ::CloseHandle(mMapping);
+   mMapping = nullptr;
+#else
+   ::munmap(mView, mCapacity);
+#endif
+
+   mView = nullptr;
+   mCapacity = 0;
+}
+
+/// Copy text into the mapping, growing the file if it doesn't fit            
+///   @param text - the text to append                                        
+void MappedFile::Write(const TextView& text) noexcept {
+   if (mUsed + text.size() > mCapacity) {
+      const auto step = mPolicy.preallocate;
+      const auto previous = mCapacity;
+      if (not Map((mUsed + text.size() + step - 1) / step * step)) {
+         // Out of space, so keep what was written so far, and drop     
+         // the text                                                    
+         Map(previous);
+         return;
+      }
+   }
+
+   ::std::memcpy(mView + mUsed, text.data(), text.size());
+   mUsed += text.size();
+}
+
+/// Start writing a new line - call it after committing the previous one,     
+/// so that syncing depends on the intent of the line that ended              
+///   @param intent - the intent of the new line                              
+void MappedFile::BeginLine(Intent intent) noexcept {
+   mLineIntent = intent;
+}
+
+/// Force the written pages to the disk at the end of a line, if the          
+/// sync policy says so                                                       
+void MappedFile::Commit() noexcept {
+   const bool sync = mPolicy.sync == FilePolicy::AlwaysSync
+      or (mPolicy.sync == FilePolicy::SyncErrors and (
+         mLineIntent == Intent::Error or
+         mLineIntent == Intent::FatalError));
+   if (sync)
+      Sync(true);
+}
+
+/// Schedule the written pages for writing to the disk, without waiting       
+void MappedFile::Flush() noexcept {
+   Sync(false);
+}
+
+/// Discard all contents of the file                                          
+void MappedFile::Truncate() noexcept {
+   if (mView)
+      ::std::memset(mView, 0, mUsed);
+   mUsed = 0;
+}
+
+/// Write the used pages back to the file                                     
+///   @param wait - whether to block until they're on the disk                
+void MappedFile::Sync(bool wait) noexcept {
+   if (not mView or not mUsed)
+      return;
+
+#ifdef _WIN32
+   ::FlushViewOfFile(mView, mUsed);
+   if (wait)
+      ::FlushFileBuffers(mFile);
+#else
+   ::msync(mView, mUsed, wait ? MS_SYNC : MS_ASYNC);
+#endif
+}
@@ -0,0 +1,68 @@
+///                                                                           
+/// Langulus::Logger                                                          
+/// Copyright (c) 2012 Dimo Markov <team@langulus.com>                        
+/// Part of the Langulus framework, see https://langulus.com                  
+///                                                                           
+/// SPDX-License-Identifier: MIT                                              
+///                                                                           
+#pragma once
+#include "Logger.hpp"
+
+
+namespace Langulus::Logger::Inner
+{
+
+   ///                                                                        
+   /// Log file, that is mapped in memory. Writing is a copy into the         
+   /// mapping, and the operating system writes the pages back on its own.    
+   /// The file grows in big chunks, and is trimmed to the written size when  
+   /// closed. Anything already copied survives a crash of the process, but   
+   /// then the file isn't trimmed, and ends with the zeroes of the unused    
+   /// capacity - readers should stop at the first zero byte. Text is copied  
+   /// in order, so the only damage a crash of the process does is a cut in   
+   /// the line being written. mUsed isn't needed to read the file, it only   
+   /// trims it when closed. If the system crashes, only pages, that were     
+   /// synced by the policy, are guaranteed to be on the disk                 
+   ///                                                                        
+   class MappedFile {
+      ::std::string mFilename;
+      FilePolicy mPolicy;
+
+   #ifdef _WIN32
+      void* mFile = nullptr;
+      void* mMapping = nullptr;
+   #else
+      int mFile = -1;
+   #endif
+
+      Letter* mView = nullptr;
+      size_t mCapacity = 0;
+      size_t mUsed = 0;
+
+      // Intent of the line being written, for the sync policy          
+      Intent mLineIntent = Intent::Info;
+
+      bool Map(size_t) noexcept;
+      void Unmap() noexcept;
+      void Sync(bool wait) noexcept;
+
+   public:
+      MappedFile(const TextView&, const FilePolicy&);
+      ~MappedFile();
+
+      MappedFile(const MappedFile&) = delete;
+      MappedFile& operator = (const MappedFile&) = delete;
+
+      void Write(const TextView&) noexcept;
+      void BeginLine(Intent) noexcept;
+      void Commit() noexcept;
+      void Flush() noexcept;
+      void Truncate() noexcept;
+
+      /// Get the name of the file                                            
+      const ::std::string& GetFilename() const noexcept {
+         return mFilename;
+      }
+   };
+
+} // namespace Langulus::Logger::Inner
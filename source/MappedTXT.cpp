@@ -0,0 +1,82 @@
+///                                                                           
+/// Langulus::Logger                                                          
+/// Copyright (c) 2012 Dimo Markov <team@langulus.com>                        
+/// Part of the Langulus framework, see https://langulus.com                  
+///                                                                           
+/// SPDX-License-Identifier: MIT                                              
+///                                                                           
+#include "MappedFile.hpp"
+
+using namespace Langulus;
+using namespace Langulus::Logger;
+
+
+/// Create a memory-mapped plain text file duplicator/redirector              
+///   @param filename - the relative filename of the log file                 
+///   @param policy - growth step and syncing policy                          
+ToMappedTXT::ToMappedTXT(const TextView& filename, const FilePolicy& policy)
+   : mFile {::std::make_unique<Inner::MappedFile>(filename, policy)} {
+   WriteHeader();
+}
+
+ToMappedTXT::~ToMappedTXT() {
+   WriteFooter();
+}
+
+/// Write text                                                                
+///   @param text - the text to append to the file                            
+void ToMappedTXT::Write(const TextView& text) const noexcept {
+   mFile->Write(text);
+}
+
+/// Plain text logging ignores all styles                                     
+///   @param style - the style to set                                         
+void ToMappedTXT::Write(Style) const noexcept {
+   LANGULUS(NOOP);
+}
+
+/// Remove formatting, add a new line, add a timestamp and tabulate           
+void ToMappedTXT::NewLine() const noexcept {
+   // The previous line ends here                                       
+   mFile->Commit();
+   mFile->BeginLine(Instance.GetIntent());
+
+   Write("\n");
+   Write(GetSimpleTimeView(Instance.GetLineTime()));
+   Write("|");
+   if (Instance.GetIntent() != Intent::Ignore)
+      Write(Instance.IntentStyle[int(Instance.GetIntent())].prefix);
+   else
+      Write(" ");
+   Write("| ");
+
+   auto tabs = Instance.GetTabs();
+   while (tabs) {
+      Write(Instance.TabString);
+      --tabs;
+   }
+}
+
+/// Clear the log file                                                        
+void ToMappedTXT::Clear() const noexcept {
+   mFile->Truncate();
+   WriteHeader();
+}
+
+/// Schedule everything written so far for writing to the disk                
+void ToMappedTXT::Flush() const noexcept {
+   mFile->Flush();
+}
+
+/// Write file header - just a timestamp                                      
+void ToMappedTXT::WriteHeader() const {
+   Write("Log started - ");
+   Write(GetAdvancedTimeView());
+   Write("\n\n");
+}
+
+/// Write file footer - just a timestamp                                      
+void ToMappedTXT::WriteFooter() const {
+   Write("\n\nLog ended - ");
+   Write(GetAdvancedTimeView());
+}
@@ -0,0 +1,177 @@
+///                                                                           
+/// Langulus::Logger                                                          
+/// Copyright (c) 2012 Dimo Markov <team@langulus.com>                        
+/// Part of the Langulus framework, see https://langulus.com                  
+///                                                                           
+/// SPDX-License-Identifier: MIT                                              
+///                                                                           
+#include "Async.hpp"
+
+using namespace Langulus;
+using namespace Langulus::Logger;
+
+
+/// Wrap an attachment, and start its background thread                       
+///   @attention the wrapper doesn't have ownership of the attachment, which  
+///      must outlive it                                                      
+///   @param sink - the attachment to write to                                
+///   @param capacity - the number of records the queue can hold              
+///   @param overflow - what to do when the queue is full                     
+QueuedSink::QueuedSink(const A::Interface& sink, size_t capacity, Overflow overflow)
+   : mSink     {sink}
+   , mOverflow {overflow}
+   , mWorker   {::std::make_unique<Inner::Worker>(capacity,
+      [this](const Inner::Record& record) { Dispatch(record); })} {
+   mWorker->Start();
+}
+
+/// Write everything that is queued, and stop the background thread           
+QueuedSink::~QueuedSink() {
+   mWorker->Stop();
+}
+
+/// Queue text, split into as many records, as required                       
+///   @param stdString - the text to write                                    
+void QueuedSink::Write(const TextView& stdString) const noexcept {
+   auto text = stdString;
+   do {
+      Inner::Record record;
+      record.type = Inner::Record::Text;
+      record.intent = Instance.GetIntent();
+      record.tabs = static_cast<uint32_t>(Instance.GetTabs());
+      record.size = static_cast<uint16_t>(
+         ::std::min(text.size(), Inner::Record::Capacity));
+      ::std::memcpy(record.text, text.data(), record.size);
+      Push(&record, 1);
+      text.remove_prefix(record.size);
+   }
+   while (not text.empty());
+}
+
+/// Queue a style change                                                      
+///   @param s - the style                                                    
+void QueuedSink::Write(Style s) const noexcept {
+   Inner::Record record;
+   record.type = Inner::Record::Stylize;
+   record.intent = Instance.GetIntent();
+   record.tabs = static_cast<uint32_t>(Instance.GetTabs());
+   record.style = s;
+   record.size = 0;
+   Push(&record, 1);
+}
+
+/// Queue a new line, along with the time, intent, tabs and style it has      
+void QueuedSink::NewLine() const noexcept {
+   Inner::Record record;
+   record.type = Inner::Record::NewLine;
+   record.intent = Instance.GetIntent();
+   record.tabs = static_cast<uint32_t>(Instance.GetTabs());
+   record.time = Instance.GetLineTime();
+   record.style = Instance.GetCurrentStyle();
+   record.size = 0;
+   Push(&record, 1);
+}
+
+/// Queue clearing the log                                                    
+void QueuedSink::Clear() const noexcept {
+   Inner::Record record;
+   record.type = Inner::Record::Clear;
+   record.intent = Instance.GetIntent();
+   record.tabs = static_cast<uint32_t>(Instance.GetTabs());
+   record.size = 0;
+   Push(&record, 1);
+}
+
+/// Block until everything queued so far has been written, and make the       
+/// attachment write anything it has buffered                                 
+void QueuedSink::Flush() const noexcept {
+   Inner::Record record;
+   record.type = Inner::Record::Flush;
+   record.intent = Instance.GetIntent();
+   record.tabs = static_cast<uint32_t>(Instance.GetTabs());
+   record.size = 0;
+
+   // Flushing waits for the attachment anyway, so it is never dropped  
+   mWorker->Push(&record, 1);
+   mWorker->Flush();
+}
+
+/// Get the state of the queue                                                
+///   @return the statistics                                                  
+SinkStatistics QueuedSink::GetStatistics() const noexcept {
+   SinkStatistics result;
+   result.pending = mWorker->GetPending();
+   result.capacity = mWorker->GetCapacity();
+   result.dispatched = mWorker->GetDispatched();
+   result.dropped = mDropped.load(::std::memory_order_relaxed);
+   result.lag = ::std::chrono::nanoseconds {
+      mLag.load(::std::memory_order_relaxed)};
+   result.maxLag = ::std::chrono::nanoseconds {
+      mMaxLag.load(::std::memory_order_relaxed)};
+   return result;
+}
+
+/// Push records to the queue, according to the overflow policy               
+///   @param records - the records to push                                    
+///   @param count - the number of records                                    
+void QueuedSink::Push(const Inner::Record* records, size_t count) const noexcept {
+   if (mOverflow == Block) {
+      mWorker->Push(records, count);
+      return;
+   }
+
+   // Once a record is dropped, the rest of its line is dropped, too,   
+   // so that the attachment never receives a line with holes in it     
+   const bool startsLine = records->type == Inner::Record::NewLine
+                        or records->type == Inner::Record::Clear;
+   if (not startsLine and mDropping.load(::std::memory_order_relaxed)) {
+      mDropped.fetch_add(count, ::std::memory_order_relaxed);
+      return;
+   }
+
+   if (mWorker->TryPush(records, count)) {
+      if (startsLine)
+         mDropping.store(false, ::std::memory_order_relaxed);
+      return;
+   }
+
+   mDropping.store(true, ::std::memory_order_relaxed);
+   mDropped.fetch_add(count, ::std::memory_order_relaxed);
+}
+
+/// Write a record to the attachment, on the background thread                
+///   @param record - the record to write                                     
+void QueuedSink::Dispatch(const Inner::Record& record) const noexcept {
+   Inner::UseContext(record);
+
+   switch (record.type) {
+   case Inner::Record::Text:
+      mSink.Write(TextView {record.text, record.size});
+      break;
+   case Inner::Record::Stylize:
+      mSink.Write(record.style);
+      break;
+   case Inner::Record::NewLine: {
+      const auto lag = ::std::chrono::duration_cast<::std::chrono::nanoseconds>(
+         TimePoint::clock::now() - record.time).count();
+      mLag.store(lag, ::std::memory_order_relaxed);
+      if (lag > mMaxLag.load(::std::memory_order_relaxed))
+         mMaxLag.store(lag, ::std::memory_order_relaxed);
+
+      mSink.NewLine();
+      break;
+   }
+   case Inner::Record::Clear:
+      mSink.Clear();
+      break;
+   case Inner::Record::Flush:
+      mSink.Flush();
+      break;
+   case Inner::Record::Deferred: {
+      ::fmt::memory_buffer formatted;
+      record.formatter(record.text, formatted);
+      mSink.Write(TextView {formatted.data(), formatted.size()});
+      break;
+   }
+   }
+}
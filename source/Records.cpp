@@ -0,0 +1,148 @@
+///                                                                           
+/// Langulus::Logger                                                          
+/// Copyright (c) 2012 Dimo Markov <team@langulus.com>                        
+/// Part of the Langulus framework, see https://langulus.com                  
+///                                                                           
+/// SPDX-License-Identifier: MIT                                              
+///                                                                           
+#include "Records.hpp"
+
+using namespace Langulus;
+using namespace Langulus::Logger;
+using namespace Langulus::Logger::Inner;
+
+
+/// Start a line, or continue the previous one                                
+///   @param newLine - false if the text continues a line, that was already   
+///      delivered                                                            
+///   @param time - when the line was started                                 
+///   @param intent - the intent of the line                                  
+///   @param tabs - the tabulation of the line                                
+///   @param style - the style the line starts with                           
+void Lines::Begin(bool newLine, TimePoint time, Intent intent, size_t tabs, Style style) noexcept {
+   // Records that were taken are no longer in use                      
+   if (mLines.empty())
+      mText.clear();
+
+   try {
+      mLines.push_back({time, intent, static_cast<uint32_t>(tabs), newLine, mRuns.size()});
+      mRuns.push_back({style, mText.size(), 0});
+   }
+   catch (...) { Clear(); }
+}
+
+/// Append text to the current run                                            
+///   @param text - the text to append                                        
+void Lines::Write(const TextView& text) noexcept {
+   if (mRuns.empty())
+      return;
+
+   try {
+      mText += text;
+      mRuns.back().mSize += text.size();
+   }
+   catch (...) { Clear(); }
+}
+
+/// Start a new run in the given style, unless the current one is empty       
+///   @param style - the style of the run                                     
+void Lines::Write(Style style) noexcept {
+   if (mRuns.empty())
+      return;
+
+   if (mRuns.back().mSize == 0) {
+      mRuns.back().mStyle = style;
+      return;
+   }
+
+   try { mRuns.push_back({style, mText.size(), 0}); }
+   catch (...) { Clear(); }
+}
+
+/// Turn everything assembled so far into records, and start over             
+///   @attention records are valid only until the next change                 
+///   @return the records                                                     
+auto Lines::Take() noexcept -> ::std::span<const LogRecord> {
+   try {
+      mRecords.clear();
+      mLogRuns.clear();
+      mLogRuns.reserve(mRuns.size());
+      mRecords.reserve(mLines.size());
+
+      // Empty runs carry nothing to render, so they are left out       
+      for (size_t i = 0; i < mLines.size(); ++i) {
+         const auto& line = mLines[i];
+         const auto end = i + 1 < mLines.size()
+            ? mLines[i + 1].mFirstRun : mRuns.size();
+
+         const auto first = mLogRuns.size();
+         for (auto r = line.mFirstRun; r < end; ++r) {
+            const auto& run = mRuns[r];
+            if (run.mSize)
+               mLogRuns.push_back({run.mStyle, {mText.data() + run.mOffset, run.mSize}});
+         }
+
+         // Continuing a line with nothing is not worth a record        
+         if (not line.mNewLine and first == mLogRuns.size())
+            continue;
+
+         mRecords.push_back({line.mTime, line.mIntent, line.mTabs, line.mNewLine,
+            {mLogRuns.data() + first, mLogRuns.size() - first}});
+      }
+   }
+   catch (...) { mRecords.clear(); }
+
+   mLines.clear();
+   mRuns.clear();
+   return mRecords;
+}
+
+/// Discard everything assembled                                              
+void Lines::Clear() noexcept {
+   mLines.clear();
+   mRuns.clear();
+   mText.clear();
+}
+
+
+/// Create a record sink                                                      
+A::RecordSink::RecordSink()
+   : mLines {::std::make_unique<Inner::Lines>()} {}
+
+/// Anything that wasn't flushed is lost, because the sink that would         
+/// receive it is already destroyed                                           
+A::RecordSink::~RecordSink() {}
+
+/// Assemble text, that arrives on its own                                    
+///   @param text - the text to append to the line                            
+void A::RecordSink::Write(const TextView& text) const noexcept {
+   if (not mLines->IsOpen()) {
+      mLines->Begin(false, Instance.GetLineTime(), Instance.GetIntent(),
+         Instance.GetTabs(), Instance.GetCurrentStyle());
+   }
+
+   mLines->Write(text);
+}
+
+/// Assemble a style change, that arrives on its own - a line, that is yet    
+/// to begin, picks its style up on its own                                   
+///   @param style - the style of the text that follows                       
+void A::RecordSink::Write(Style style) const noexcept {
+   mLines->Write(style);
+}
+
+/// Deliver the line so far, and begin a new one                              
+void A::RecordSink::NewLine() const noexcept {
+   if (mLines->IsOpen())
+      WriteRecords(mLines->Take());
+
+   mLines->Begin(true, Instance.GetLineTime(), Instance.GetIntent(),
+      Instance.GetTabs(), Instance.GetCurrentStyle());
+}
+
+/// Deliver anything assembled so far. Call this from the sink's own Flush,   
+/// if it overrides it                                                        
+void A::RecordSink::Flush() const noexcept {
+   if (mLines->IsOpen())
+      WriteRecords(mLines->Take());
+}
@@ -0,0 +1,66 @@
+///                                                                           
+/// Langulus::Logger                                                          
+/// Copyright (c) 2012 Dimo Markov <team@langulus.com>                        
+/// Part of the Langulus framework, see https://langulus.com                  
+///                                                                           
+/// SPDX-License-Identifier: MIT                                              
+///                                                                           
+#pragma once
+#include "Logger.hpp"
+#include <vector>
+
+
+namespace Langulus::Logger::Inner
+{
+
+   ///                                                                        
+   /// Assembles fragments of text and styles into whole lines, that are      
+   /// delivered to record sinks. Runs refer to the text by offsets while     
+   /// assembling, and are turned into views only when records are taken      
+   ///                                                                        
+   class Lines {
+      struct Line {
+         TimePoint mTime;
+         Intent    mIntent;
+         uint32_t  mTabs;
+         bool      mNewLine;
+         size_t    mFirstRun;
+      };
+
+      struct Run {
+         Style  mStyle;
+         size_t mOffset;
+         size_t mSize;
+      };
+
+      ::std::vector<Line> mLines;
+      ::std::vector<Run>  mRuns;
+      ::std::string       mText;
+
+      // Records, as given to sinks, valid until the next change        
+      ::std::vector<LogRecord> mRecords;
+      ::std::vector<LogRun>    mLogRuns;
+
+   public:
+      // Records are delivered when any of these is reached             
+      static constexpr size_t MaxLines = 256;
+      static constexpr size_t MaxBytes = 64 * 1024;
+
+      void Begin(bool newLine, TimePoint, Intent, size_t tabs, Style) noexcept;
+      void Write(const TextView&) noexcept;
+      void Write(Style) noexcept;
+      auto Take() noexcept -> ::std::span<const LogRecord>;
+      void Clear() noexcept;
+
+      /// Check if a line has been started, and not yet taken                 
+      bool IsOpen() const noexcept {
+         return not mLines.empty();
+      }
+
+      /// Check if enough has been assembled to be worth delivering           
+      bool IsFull() const noexcept {
+         return mLines.size() >= MaxLines or mText.size() >= MaxBytes;
+      }
+   };
+
+} // namespace Langulus::Logger::Inner
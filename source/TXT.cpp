@@ -5,7 +5,7 @@
 ///                                                                           
 /// SPDX-License-Identifier: MIT                                              
 ///                                                                           
-#include "Logger.hpp"
+#include "FileWriter.hpp"
 
 using namespace Langulus;
 using namespace Langulus::Logger;
@@ -13,23 +13,21 @@ using namespace Langulus::Logger;
 
 /// Create a plain text file duplicator/redirector                            
 ///   @param filename - the relative filename of the log file                 
-ToTXT::ToTXT(const TextView& filename) : mFilename {filename} {
-   mFile.open(mFilename, std::ios::out | std::ios::trunc);
-   if (not mFile)
-      throw std::runtime_error {"Can't open log file"};
+///   @param policy - buffering, flushing and syncing policy                  
+ToTXT::ToTXT(const TextView& filename, const FilePolicy& policy)
+   : mFile {::std::make_unique<Inner::FileWriter>(filename, policy)} {
    WriteHeader();
 }
 
 ToTXT::~ToTXT() {
    WriteFooter();
-   mFile.close();
 }
 
 /// Write text                                                                
 ///   @param text - the text to append to the file                            
 void ToTXT::Write(const TextView& text) const noexcept {
-   mFile << text;
-   mFile.flush();
+   mFile->Write(text);
+   mFile->Commit(false);
 }
 
 /// Plain text logging ignores all styles                                     
@@ -40,11 +38,23 @@ void ToTXT::Write(Style) const noexcept {
 
 /// Remove formatting, add a new line, add a timestamp and tabulate           
 void ToTXT::NewLine() const noexcept {
+   // The previous line ends here                                       
+   mFile->Commit(true);
+
+   if (mFile->IsRotationDue()) {
+      // Each file is a complete log, with its own header and footer    
+      WriteFooter();
+      mFile->Rotate();
+      WriteHeader();
+   }
+
+   mFile->BeginLine(Instance.GetIntent());
+
    Write("\n");
-   Write(GetSimpleTime());
+   Write(GetSimpleTimeView(Instance.GetLineTime()));
    Write("|");
-   if (Instance.CurrentIntent != Intent::Ignore)
-      Write(Instance.IntentStyle[int(Instance.CurrentIntent)].prefix);
+   if (Instance.GetIntent() != Intent::Ignore)
+      Write(Instance.IntentStyle[int(Instance.GetIntent())].prefix);
    else
       Write(" ");
    Write("| ");
@@ -60,20 +70,24 @@ void ToTXT::NewLine() const noexcept {
 
 /// Clear the log file                                                        
 void ToTXT::Clear() const noexcept {
-   mFile.close();
-   mFile.open(mFilename, std::ios::out | std::ios::trunc);
+   mFile->Truncate();
    WriteHeader();
 }
 
+/// Write anything that is buffered to the file                               
+void ToTXT::Flush() const noexcept {
+   mFile->Flush();
+}
+
 /// Write file header - just a timestamp                                      
 void ToTXT::WriteHeader() const {
    Write("Log started - ");
-   Write(GetAdvancedTime());
+   Write(GetAdvancedTimeView());
    Write("\n\n");
 }
 
 /// Write file footer - just a timestamp                                      
 void ToTXT::WriteFooter() const {
    Write("\n\nLog ended - ");
-   Write(GetAdvancedTime());
+   Write(GetAdvancedTimeView());
 }
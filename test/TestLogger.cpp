@@ -7,6 +7,135 @@
 ///                                                                           
 #include "Main.hpp"
 #include <catch2/catch.hpp>
+#include <sstream>
+#include <thread>
+#include <fmt/chrono.h>
+#include <fstream>
+#include "../source/Escape.hpp"
+
+#ifndef _WIN32
+   #include <csignal>
+   #include <unistd.h>
+   #include <sys/wait.h>
+   #include <fcntl.h>
+#endif
+
+
+/// Redirector, that collects everything in a string, one line per NewLine    
+struct Capture final : Logger::A::Interface {
+   mutable std::string mText;
+
+   void Write(const Logger::TextView& text) const noexcept { mText += text; }
+   void Write(Logger::Style) const noexcept {}
+   void NewLine() const noexcept { mText += '\n'; }
+   void Clear() const noexcept { mText.clear(); }
+};
+
+
+/// Capture, that can't start a line until it is opened                       
+struct Gated final : Logger::A::Interface {
+   mutable std::string mText;
+   std::atomic<bool> mOpen {false};
+
+   void Write(const Logger::TextView& text) const noexcept { mText += text; }
+   void Write(Logger::Style) const noexcept {}
+   void NewLine() const noexcept {
+      while (not mOpen)
+         std::this_thread::sleep_for(std::chrono::milliseconds {1});
+      mText += '\n';
+   }
+   void Clear() const noexcept { mText.clear(); }
+};
+
+
+/// Attachment, that only counts lines, and can be used from many threads     
+struct CountLines final : Logger::A::Interface {
+   mutable std::atomic<size_t> mLines {0};
+
+   void Write(const Logger::TextView&) const noexcept {}
+   void Write(Logger::Style) const noexcept {}
+   void NewLine() const noexcept { ++mLines; }
+   void Clear() const noexcept {}
+};
+
+
+/// Record sink, that keeps a copy of every record it receives                
+struct CaptureRecords final : Logger::A::RecordSink {
+   struct Copy {
+      Logger::Intent mIntent;
+      uint32_t mTabs;
+      bool mNewLine;
+      size_t mRuns;
+      std::string mText;
+   };
+
+   mutable std::vector<Copy> mRecords;
+   mutable size_t mCalls = 0;
+
+   void WriteRecords(std::span<const Logger::LogRecord> records) const noexcept {
+      ++mCalls;
+      for (auto& record : records) {
+         Copy copy {record.intent, record.tabs, record.newLine, record.runs.size(), {}};
+         for (auto& run : record.runs)
+            copy.mText += run.text;
+         mRecords.push_back(copy);
+      }
+   }
+
+   void Clear() const noexcept { mRecords.clear(); }
+};
+
+
+/// A type that counts how many times it was formatted                        
+struct Counted {
+   static inline int sFormatted = 0;
+};
+
+template<>
+struct fmt::formatter<Counted> : fmt::formatter<int> {
+   auto format(const Counted&, format_context& ctx) const {
+      return fmt::formatter<int>::format(++Counted::sFormatted, ctx);
+   }
+};
+
+
+/// A trivially copyable type, that remembers the thread it was formatted on  
+struct Deferred {
+   int mValue;
+   static inline std::thread::id sFormattedOn;
+};
+
+namespace Langulus::Logger
+{
+   template<>
+   constexpr bool DeferredFormatting<Deferred> = true;
+}
+
+template<>
+struct fmt::formatter<Deferred> : fmt::formatter<int> {
+   auto format(const Deferred& d, format_context& ctx) const {
+      Deferred::sFormattedOn = std::this_thread::get_id();
+      return fmt::formatter<int>::format(d.mValue, ctx);
+   }
+};
+
+
+/// A type, whose formatting waits for another thread to format one, too,     
+/// and gives up after a while. Formatted as the number of threads that met   
+struct Rendezvous {
+   static inline std::atomic<int> sArrived {0};
+};
+
+template<>
+struct fmt::formatter<Rendezvous> : fmt::formatter<int> {
+   auto format(const Rendezvous&, format_context& ctx) const {
+      ++Rendezvous::sArrived;
+      const auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds {2};
+      while (Rendezvous::sArrived < 2 and std::chrono::steady_clock::now() < deadline)
+         std::this_thread::yield();
+      return fmt::formatter<int>::format(Rendezvous::sArrived.load(), ctx);
+   }
+};
 
 
 SCENARIO("Logging to console", "[logger]") {
@@ -182,22 +311,1545 @@ SCENARIO("Logging to console", "[logger]") {
    }
 }
 
+SCENARIO("Logging asynchronously", "[logger]") {
+   GIVEN("A logger in asynchronous mode, redirected to a capture") {
+      Capture capture;
+      Logger::AttachRedirector(&capture);
+      Logger::SetAsync(true);
+
+      WHEN("Logging from several threads at once") {
+         constexpr int Threads = 4;
+         constexpr int Lines = 2500;
+         std::vector<std::thread> threads;
+         for (int t = 0; t < Threads; ++t) {
+            threads.emplace_back([t] {
+               for (int i = 0; i < Lines; ++i)
+                  Logger::Info("thread ", t, " line ", i, " end");
+            });
+         }
+
+         for (auto& thread : threads)
+            thread.join();
+         Logger::Flush();
+
+         THEN("Every line arrives in one piece, in per-thread order") {
+            std::istringstream stream {capture.mText};
+            std::string line;
+            int lines = 0;
+            int next[Threads] {};
+            while (std::getline(stream, line)) {
+               if (line.empty())
+                  continue;
+
+               int t = -1, i = -1;
+               char tail[8] {};
+               REQUIRE(sscanf(line.c_str(), "thread %d line %d %7s", &t, &i, tail) == 3);
+               REQUIRE(std::string {tail} == "end");
+               REQUIRE(i == next[t]++);
+               ++lines;
+            }
+            REQUIRE(lines == Threads * Lines);
+         }
+      }
+
+      WHEN("Logging values that allow deferred formatting") {
+         Logger::Info("Deferred ", Deferred {42}, ' ', 3.5f, ' ', -7, ' ', 2.25);
+         Logger::Flush();
+
+         THEN("They are formatted by the background thread") {
+            REQUIRE(capture.mText.find("Deferred 42 3.5 -7 2.25") != std::string::npos);
+            REQUIRE(Deferred::sFormattedOn != std::this_thread::get_id());
+         }
+      }
+
+      Logger::SetAsync(false);
+      Logger::DettachRedirector(&capture);
+   }
+}
+
+SCENARIO("Attaching and dettaching while logging", "[logger]") {
+   GIVEN("Several threads, logging to a redirector") {
+      constexpr int Threads = 4;
+      constexpr int Lines = 5000;
+      CountLines counter;
+      Logger::AttachRedirector(&counter);
+
+      std::vector<std::thread> threads;
+      for (int t = 0; t < Threads; ++t) {
+         threads.emplace_back([] {
+            for (int i = 0; i < Lines; ++i)
+               Logger::Info("line ", i);
+         });
+      }
+
+      WHEN("Other attachments come and go in the meantime") {
+         size_t attached = 0;
+         while (attached < 200) {
+            auto other = std::make_unique<CountLines>();
+            Logger::AttachRedirector(other.get());
+            Logger::AttachDuplicator(other.get());
+            std::this_thread::yield();
+            Logger::DettachDuplicator(other.get());
+            Logger::DettachRedirector(other.get());
+            // Destroying it right away must be safe                    
+            other.reset();
+            ++attached;
+         }
+
+         for (auto& thread : threads)
+            thread.join();
+
+         THEN("The redirector that stayed receives every line") {
+            REQUIRE(counter.mLines == Threads * Lines);
+         }
+      }
+
+      Logger::DettachRedirector(&counter);
+   }
+}
+
+SCENARIO("Attachments that receive only some intents", "[logger]") {
+   GIVEN("A redirector for infos, and a duplicator for errors and warnings") {
+      Capture infos, problems;
+      Logger::AttachRedirector(&infos, Logger::Intent::Info);
+      Logger::AttachDuplicator(&problems, Logger::Intent::Error | Logger::Intent::Warning);
+
+      WHEN("Logging with different intents") {
+         Logger::Info("Masked info");
+         Logger::Error("Masked error");
+         Logger::Warning("Masked warning");
+         Logger::Verbose("Masked verbose");
+
+         THEN("Each attachment gets only its intents") {
+            REQUIRE(infos.mText == "\nMasked info");
+            REQUIRE(problems.mText == "\nMasked error\nMasked warning");
+         }
+      }
+
+      Logger::DettachDuplicator(&problems);
+      Logger::DettachRedirector(&infos);
+   }
+
+   GIVEN("An intent mask") {
+      constexpr auto mask = Logger::Intent::Error | Logger::Intent::FatalError;
+
+      THEN("It contains only the intents it was made of") {
+         static_assert(mask.Contains(Logger::Intent::Error));
+         static_assert(mask.Contains(Logger::Intent::FatalError));
+         static_assert(not mask.Contains(Logger::Intent::Info));
+         static_assert(not mask.Contains(Logger::Intent::Ignore));
+         static_assert(Logger::IntentMask {}.Contains(Logger::Intent::Prompt));
+         REQUIRE(mask == (Logger::IntentMask {Logger::Intent::FatalError} | Logger::Intent::Error));
+      }
+   }
+}
+
+SCENARIO("Attachments that receive whole records", "[logger]") {
+   GIVEN("A record sink as a redirector") {
+      CaptureRecords records;
+      Logger::AttachRedirector(&records);
+
+      WHEN("Logging a statement in several styles, and appending to it") {
+         Logger::Info("Hello ", Logger::Red, "world");
+         const auto callsAfterStatement = records.mCalls;
+         Logger::Append(" again");
+
+         THEN("The statement arrives as a single record, once it ends") {
+            REQUIRE(callsAfterStatement == 1);
+            REQUIRE(records.mRecords.size() == 2);
+            REQUIRE(records.mRecords[0].mIntent == Logger::Intent::Info);
+            REQUIRE(records.mRecords[0].mNewLine);
+            REQUIRE(records.mRecords[0].mRuns >= 2);
+            REQUIRE(records.mRecords[0].mText == "Hello world");
+            REQUIRE_FALSE(records.mRecords[1].mNewLine);
+            REQUIRE(records.mRecords[1].mText == " again");
+         }
+      }
+
+      WHEN("Logging a tabulated section") {
+         {
+            const auto tab = Logger::WarningTab("Section");
+            Logger::Verbose("Inside");
+         }
+         Logger::Verbose("Outside");
+
+         THEN("Each record carries its own intent and tabs") {
+            REQUIRE(records.mRecords.size() == 3);
+            REQUIRE(records.mRecords[0].mIntent == Logger::Intent::Warning);
+            REQUIRE(records.mRecords[0].mTabs == 0);
+            REQUIRE(records.mRecords[1].mIntent == Logger::Intent::Verbose);
+            REQUIRE(records.mRecords[1].mTabs == 1);
+            REQUIRE(records.mRecords[2].mTabs == 0);
+         }
+      }
+
+      WHEN("Logging many lines asynchronously") {
+         constexpr int Lines = 1000;
+         Logger::SetAsync(true);
+         for (int i = 0; i < Lines; ++i)
+            Logger::Info("line ", i);
+         Logger::Flush();
+         Logger::SetAsync(false);
+
+         THEN("They arrive in order, in batches") {
+            REQUIRE(records.mRecords.size() == Lines);
+            REQUIRE(records.mCalls < Lines);
+            for (int i = 0; i < Lines; ++i)
+               REQUIRE(records.mRecords[i].mText == fmt::format("line {}", i));
+         }
+      }
+
+      Logger::DettachRedirector(&records);
+   }
+
+   GIVEN("A record sink on its own queue") {
+      CaptureRecords records;
+      Logger::QueuedSink queued {records};
+      Logger::AttachRedirector(&queued);
+
+      WHEN("Logging a few lines") {
+         Logger::Info("One");
+         Logger::Info("Two");
+         Logger::Flush();
+
+         THEN("The fragments are assembled into records") {
+            REQUIRE(records.mRecords.size() == 2);
+            REQUIRE(records.mRecords[0].mText == "One");
+            REQUIRE(records.mRecords[1].mText == "Two");
+            REQUIRE(records.mRecords[1].mNewLine);
+         }
+      }
+
+      Logger::DettachRedirector(&queued);
+   }
+}
+
+SCENARIO("Attachments with their own queues", "[logger]") {
+   GIVEN("A capture, and a stuck attachment on its own queue") {
+      constexpr int Lines = 200;
+      Capture capture;
+      Gated gated;
+      Logger::QueuedSink queued {gated, 16};
+      Logger::AttachRedirector(&capture);
+      Logger::AttachRedirector(&queued);
+
+      WHEN("Logging more than the queue can hold") {
+         for (int i = 0; i < Lines; ++i)
+            Logger::Info("line ", i, " end");
+
+         THEN("Nothing waits for the stuck attachment") {
+            REQUIRE(std::count(capture.mText.begin(), capture.mText.end(), '\n') == Lines);
+
+            const auto stats = queued.GetStatistics();
+            REQUIRE(stats.capacity == 16);
+            REQUIRE(stats.pending <= stats.capacity);
+            REQUIRE(stats.dropped > 0);
+         }
+
+         gated.mOpen = true;
+         queued.Flush();
+
+         THEN("The attachment gets whole lines, once it is unstuck") {
+            const auto stats = queued.GetStatistics();
+            REQUIRE(stats.pending == 0);
+            REQUIRE(stats.dispatched > 0);
+            REQUIRE(stats.maxLag > std::chrono::nanoseconds {0});
+
+            std::istringstream stream {gated.mText};
+            std::string line;
+            int previous = -1;
+            while (std::getline(stream, line)) {
+               if (line.empty())
+                  continue;
+
+               int i = -1;
+               REQUIRE(sscanf(line.c_str(), "line %d", &i) == 1);
+               REQUIRE(i > previous);
+               previous = i;
+            }
+         }
+      }
+
+      WHEN("The queue waits for room, instead of dropping") {
+         gated.mOpen = true;
+         Logger::QueuedSink blocking {gated, 16, Logger::QueuedSink::Block};
+         Logger::DettachRedirector(&queued);
+         gated.mText.clear();
+         Logger::AttachRedirector(&blocking);
+
+         for (int i = 0; i < Lines; ++i)
+            Logger::Info("line ", i, " end");
+         blocking.Flush();
+         Logger::DettachRedirector(&blocking);
+
+         THEN("Every line arrives, in order") {
+            REQUIRE(blocking.GetStatistics().dropped == 0);
+            REQUIRE(gated.mText == capture.mText);
+         }
+      }
+
+      gated.mOpen = true;
+      Logger::DettachRedirector(&queued);
+      Logger::DettachRedirector(&capture);
+   }
+}
+
+SCENARIO("Suppressing repeated lines", "[logger]") {
+   GIVEN("A logger that suppresses repeats, redirected to a capture") {
+      Capture capture;
+      Logger::AttachRedirector(&capture);
+      Logger::Instance.SuppressRepeats = true;
+
+      for (bool async : {false, true}) {
+         Logger::SetAsync(async);
+
+         WHEN((async ? "Repeating a line asynchronously" : "Repeating a line")) {
+            for (int i = 0; i < 1000; ++i)
+               Logger::Error("The same error ", 42);
+            Logger::Info("Something else");
+            Logger::Flush();
+
+            THEN("The repeats are replaced with a single line") {
+               REQUIRE(capture.mText.find("The same error 42") != std::string::npos);
+               REQUIRE(capture.mText.find("The same error 42") == capture.mText.rfind("The same error 42"));
+               REQUIRE(capture.mText.find("repeated 999 more times") != std::string::npos);
+               REQUIRE(capture.mText.find("repeated 999 more times") < capture.mText.find("Something else"));
+            }
+         }
+
+         WHEN((async ? "Repeating a line asynchronously, then flushing" : "Repeating a line, then flushing")) {
+            Logger::Warning("A repeated warning");
+            Logger::Warning("A repeated warning");
+            Logger::Warning("A repeated warning");
+            Logger::Flush();
+
+            THEN("Flushing writes the repeats that are held back") {
+               REQUIRE(capture.mText.find("A repeated warning") == capture.mText.rfind("A repeated warning"));
+               REQUIRE(capture.mText.find("repeated 2 more times") != std::string::npos);
+            }
+         }
+
+         Logger::SetAsync(false);
+         capture.mText.clear();
+      }
+
+      WHEN("Repeating a line asynchronously, and logging nothing after it") {
+         const auto timeout = Logger::Instance.RepeatTimeout;
+         Logger::Instance.RepeatTimeout = std::chrono::milliseconds {10};
+         Logger::SetAsync(true);
+         Logger::Warning("A warning repeated before a pause");
+         Logger::Warning("A warning repeated before a pause");
+         std::this_thread::sleep_for(std::chrono::milliseconds {300});
+         Logger::SetAsync(false);
+         Logger::Instance.RepeatTimeout = timeout;
+
+         THEN("The worker writes the repeats, when the timeout passes") {
+            REQUIRE(capture.mText.find("repeated 1 more times") != std::string::npos);
+         }
+      }
+
+      Logger::Instance.SuppressRepeats = false;
+      Logger::DettachRedirector(&capture);
+   }
+}
+
+
+SCENARIO("Throttling call sites", "[logger]") {
+   GIVEN("A logger redirected to a capture") {
+      Capture capture;
+      Logger::AttachRedirector(&capture);
+      int evaluated = 0;
+      const auto evaluate = [&evaluated] { return ++evaluated; };
+
+      WHEN("Logging only every 10th statement from a call site") {
+         for (int i = 0; i < 100; ++i)
+            LANGULUS_LOG_EVERY(10, Verbose, "Sampled ", i, ' ', evaluate());
+
+         THEN("Only every 10th statement is logged, and the skips are counted") {
+            REQUIRE(std::ranges::count(capture.mText, '\n') == 10);
+            REQUIRE(evaluated == 10);
+            REQUIRE(capture.mText.find("Sampled 0 1\n") != std::string::npos);
+            REQUIRE(capture.mText.find("Sampled 10 2 (skipped 9 more)") != std::string::npos);
+            REQUIRE(capture.mText.find("Sampled 11") == std::string::npos);
+         }
+      }
+
+      WHEN("Flushing after statements were skipped from a call site") {
+         for (int i = 0; i < 15; ++i)
+            LANGULUS_LOG_EVERY(10, Verbose, "Sampled ", i);
+         Logger::Flush();
+
+         THEN("The skipped statements are reported by the flush") {
+            REQUIRE(capture.mText.starts_with("\nSampled 0\nSampled 10 (skipped 9 more)\nTestLogger.cpp:"));
+            REQUIRE(capture.mText.ends_with(" skipped 4 more"));
+         }
+      }
+
+      WHEN("Logging statements, that end with tabs, from a call site") {
+         for (int i = 0; i < 15; ++i)
+            LANGULUS_LOG_EVERY(10, Verbose, "Tabbed ", i, Logger::Tabs {});
+
+         THEN("The skips are counted after the statement, and no tabs remain") {
+            REQUIRE(capture.mText == "\nTabbed 0\nTabbed 10 (skipped 9 more)");
+            REQUIRE(Logger::Instance.GetTabs() == 0);
+         }
+      }
+
+      WHEN("Statements that pass a call site are silenced") {
+         Logger::Silence(Logger::Intent::Verbose);
+         for (int i = 0; i < 5; ++i) {
+            if (i == 4)
+               Logger::Unsilence(Logger::Intent::Verbose);
+            LANGULUS_LOG_EVERY(2, Verbose, "Silenced ", i);
+         }
+
+         THEN("The skipped statements are reported by the next written one") {
+            REQUIRE(capture.mText == "\nSilenced 4 (skipped 2 more)");
+         }
+      }
+
+      WHEN("Logging at most 5 statements per second from a call site") {
+         for (int i = 0; i < 1000; ++i)
+            LANGULUS_LOG_RATE(5, Network, "Packet ", i, ' ', evaluate());
+
+         THEN("Only a burst of 5 statements is logged") {
+            const auto lines = std::ranges::count(capture.mText, '\n');
+            REQUIRE(lines >= 5);
+            REQUIRE(lines < 10);
+            REQUIRE(evaluated == lines);
+            REQUIRE(capture.mText.find("Packet 4 5") != std::string::npos);
+         }
+      }
+
+      WHEN("Dettaching after statements were skipped from a call site") {
+         for (int i = 0; i < 15; ++i)
+            LANGULUS_LOG_EVERY(10, Verbose, "Sampled ", i);
+         Logger::DettachRedirector(&capture);
+         const auto text = capture.mText;
+         Logger::AttachRedirector(&capture);
+
+         THEN("The skipped statements aren't reported by dettaching") {
+            REQUIRE(text == "\nSampled 0\nSampled 10 (skipped 9 more)");
+         }
+      }
+
+      // Dettaching doesn't report skips, so report them while the      
+      // capture is still there                                         
+      Logger::Flush();
+      Logger::DettachRedirector(&capture);
+   }
+}
+
+
+/// Log from a registered call site                                           
+void LogFromCallSite(int i) {
+   LANGULUS_LOG(Info, "Registered ", i);
+}
+
+/// Log a fatal error from a registered call site                             
+void LogFatalFromCallSite() {
+   LANGULUS_LOG(Fatal, "Registered fatal error");
+}
+
+/// A registered call site, that is never reached                            
+void NeverLogFromCallSite() {
+   LANGULUS_LOG(Verbose, "Never reached");
+}
+
+SCENARIO("Registered call sites", "[logger]") {
+   GIVEN("A logger redirected to a capture, and a registered call site") {
+      Capture capture;
+      Logger::AttachRedirector(&capture);
+      LogFromCallSite(0);
+
+      Logger::CallSite* site = Logger::CallSite::First();
+      while (site and site->format != "\"Registered \", i")
+         site = site->Next();
+
+      THEN("The call site is described in the registry") {
+         REQUIRE(site);
+         REQUIRE(site->file.ends_with("TestLogger.cpp"));
+         REQUIRE(site->line > 0);
+         REQUIRE(site->function == "LogFromCallSite");
+         REQUIRE(site->intent == Logger::Intent::Info);
+         REQUIRE(site->IsEnabled());
+         REQUIRE(capture.mText == "\nRegistered 0");
+      }
+
+      WHEN("The call site is switched off, and then on again") {
+         REQUIRE(Logger::EnableCallSites(false, "TestLogger.cpp", site->line) == 1);
+         LogFromCallSite(1);
+         REQUIRE(Logger::EnableCallSites(true, "TestLogger.cpp") >= 1);
+         LogFromCallSite(2);
+
+         THEN("Nothing is logged from it while it is off") {
+            REQUIRE(capture.mText == "\nRegistered 0\nRegistered 2");
+         }
+      }
+
+      WHEN("Looking for a call site, that was never reached") {
+         Logger::CallSite* never = Logger::CallSite::First();
+         while (never and never->format != "\"Never reached\"")
+            never = never->Next();
+
+         THEN("It is registered already") {
+            REQUIRE(never);
+            REQUIRE(never->function == "NeverLogFromCallSite");
+            REQUIRE(never->intent == Logger::Intent::Verbose);
+         }
+      }
+
+      WHEN("The whole file is switched off, and then on again") {
+         Logger::EnableCallSites(false, "TestLogger.cpp");
+         LogFatalFromCallSite();
+         Logger::EnableCallSites(true, "TestLogger.cpp");
+
+         Logger::CallSite* fatal = Logger::CallSite::First();
+         while (fatal and fatal->format != "\"Registered fatal error\"")
+            fatal = fatal->Next();
+
+         THEN("Nothing is logged from the file while it is off") {
+            REQUIRE(fatal);
+            REQUIRE(fatal->intent == Logger::Intent::FatalError);
+            REQUIRE(fatal->IsEnabled());
+            REQUIRE(capture.mText == "\nRegistered 0");
+         }
+      }
+
+      Logger::DettachRedirector(&capture);
+   }
+}
+
+
+SCENARIO("Formatting arguments", "[logger]") {
+   GIVEN("A logger redirected to a capture") {
+      Capture capture;
+      Logger::AttachRedirector(&capture);
+
+      WHEN("Logging arithmetic types, characters and other formattables") {
+         Logger::Info(true, ' ', false, ' ', 'x', ' ', u8'y', ' ',
+            -42, ' ', 42u, ' ', short(-7), ' ', static_cast<signed char>(-5), ' ',
+            std::numeric_limits<long long>::min(), ' ',
+            std::numeric_limits<unsigned long long>::max(), ' ',
+            1.5, ' ', 0.1f, ' ', std::string(600, 'z').size());
+
+         THEN("The output is the same as fmt's") {
+            REQUIRE(capture.mText == fmt::format("\n{} {} x y -42 42 -7 -5 {} {} 1.5 0.1 600",
+               true, false,
+               std::numeric_limits<long long>::min(),
+               std::numeric_limits<unsigned long long>::max()));
+         }
+      }
+
+      Logger::DettachRedirector(&capture);
+   }
+}
+
+SCENARIO("Logging with compile-time format strings", "[logger]") {
+   GIVEN("A logger redirected to a capture") {
+      Capture capture;
+      Logger::AttachRedirector(&capture);
+
+      WHEN("Logging a formatted message") {
+         const int x = 5;
+         Logger::Info(Logger::Format("x = {}, y = {:.2f}, z = {:>3}", x, 1.5, 'z'));
+
+         THEN("The message is rendered with fmt") {
+            REQUIRE(capture.mText == "\nx = 5, y = 1.50, z =   z");
+         }
+      }
+
+      WHEN("Mixing formatted messages with colors and tabs") {
+         {
+            auto tabs = Logger::WarningTab(Logger::Color::Red, Logger::Format("{} + {}", 1, 2), " = ", 3);
+            Logger::Line(Logger::Format("inside {}", "section"));
+         }
+         const auto tabsAfter = Logger::Instance.GetTabs();
+
+         THEN("Everything is written in order, and tabs are restored") {
+            REQUIRE(capture.mText == "\n1 + 2 = 3\ninside section");
+            REQUIRE(tabsAfter == 0);
+         }
+      }
+
+      WHEN("Logging a formatted message, that fails to render") {
+         const int width = -1;
+         Logger::Info(Logger::Format("[{:{}}]", 7, width), " after");
+
+         THEN("The format string is written after a marker instead") {
+            REQUIRE(capture.mText == "\n<format error> [{:{}}] after");
+         }
+      }
+
+      Logger::DettachRedirector(&capture);
+   }
+}
+
+SCENARIO("Silencing intents at runtime", "[logger]") {
+   GIVEN("A logger redirected to a capture, with verbose messages silenced") {
+      Capture capture;
+      Logger::AttachRedirector(&capture);
+      Logger::Silence(Logger::Intent::Verbose);
+      Counted::sFormatted = 0;
+
+      WHEN("Logging a verbose message, continued with a line") {
+         Logger::Verbose("silenced ", Counted {});
+         Logger::Line("also silenced ", Counted {});
+         auto tabs = Logger::VerboseTab("silenced section");
+
+         THEN("Nothing is written, and arguments are never formatted") {
+            REQUIRE(capture.mText.empty());
+            REQUIRE(Counted::sFormatted == 0);
+            REQUIRE(Logger::Instance.GetTabs() == 0);
+         }
+      }
+
+      WHEN("Logging a silenced verbose message, that ends with tabs") {
+         {
+            auto tabs = Logger::Verbose("silenced ", Counted {}, Logger::Tabs {});
+            Logger::Line("also silenced ", Logger::Tabs {});
+            REQUIRE(Logger::Instance.GetTabs() == 0);
+         }
+
+         THEN("Nothing is written, and no tabs remain") {
+            REQUIRE(capture.mText.empty());
+            REQUIRE(Counted::sFormatted == 0);
+            REQUIRE(Logger::Instance.GetTabs() == 0);
+         }
+      }
+
+      WHEN("Logging a verbose message after unsilencing") {
+         Logger::Unsilence(Logger::Intent::Verbose);
+         Logger::Verbose("not silenced ", Counted {});
+
+         THEN("The message is written") {
+            REQUIRE(capture.mText == "\nnot silenced 1");
+            REQUIRE(Counted::sFormatted == 1);
+         }
+      }
+
+      Logger::Unsilence(Logger::Intent::Verbose);
+      Logger::DettachRedirector(&capture);
+      Logger::Info();
+   }
+}
+
+SCENARIO("Recording recent history in memory", "[logger]") {
+   GIVEN("A flight recorder, and a capture with verbose messages silenced") {
+      Capture capture;
+      Logger::AttachRedirector(&capture);
+      Logger::Silence(Logger::Intent::Verbose);
+      Logger::StartFlightRecorder(64 * 1024,
+         Logger::Intent::FatalError | Logger::Intent::Verbose | Logger::Intent::Info);
+
+      WHEN("Logging silenced and unsilenced messages") {
+         Logger::Verbose("hidden ", 1);
+         Logger::Info("shown ", Deferred {7});
+
+         Capture replay;
+         const auto lines = Logger::Instance.DumpFlightRecorder(replay);
+
+         THEN("Only the unsilenced ones are written, but both are recorded") {
+            REQUIRE(capture.mText == "\nshown 7");
+            REQUIRE(lines >= 2);
+            REQUIRE(replay.mText.ends_with("\nhidden 1\nshown 7"));
+         }
+      }
+
+      WHEN("Checking if recorded intents are silenced") {
+         const bool recorded = Logger::Instance.IsSilenced(Logger::Intent::Verbose);
+         Logger::Instance.StopFlightRecorder();
+         const bool stopped = Logger::Instance.IsSilenced(Logger::Intent::Verbose);
+
+         THEN("They aren't, until recording stops, so they are formatted") {
+            REQUIRE_FALSE(recorded);
+            REQUIRE(stopped);
+         }
+      }
+
+      WHEN("Recording only the default intents") {
+         Logger::StartFlightRecorder(64 * 1024);
+         Logger::Verbose("not recorded");
+         Logger::Warning("recorded");
+
+         Capture replay;
+         Logger::Instance.DumpFlightRecorder(replay);
+
+         THEN("Silenced verbose messages keep their early-out, and aren't recorded") {
+            REQUIRE(Logger::Instance.IsSilenced(Logger::Intent::Verbose));
+            REQUIRE(replay.mText.ends_with("\nrecorded"));
+            REQUIRE(replay.mText.find("not recorded") == std::string::npos);
+         }
+      }
+
+      WHEN("Logging more than the flight recorder can hold") {
+         for (int i = 0; i < 2000; ++i)
+            Logger::Verbose("line ", i);
+
+         Capture replay;
+         const auto lines = Logger::Instance.DumpFlightRecorder(replay);
+
+         THEN("Only the most recent history is kept") {
+            REQUIRE(lines <= 64 * 1024 / 128);
+            REQUIRE(replay.mText.ends_with("\nline 1999"));
+            REQUIRE(replay.mText.find("\nline 0\n") == std::string::npos);
+         }
+      }
+
+      WHEN("Logging a fatal error") {
+         Logger::Instance.FlightRecorderFile = "flight.lgb";
+         Logger::Verbose("context before the crash");
+         Logger::Fatal("crash");
+
+         Capture decoded;
+         const auto records = Logger::DecodeBinary("flight.lgb", decoded);
+
+         THEN("The flight recorder is dumped to a binary log") {
+            REQUIRE(records > 0);
+            REQUIRE(decoded.mText.ends_with("\ncontext before the crash\ncrash"));
+         }
+
+         std::remove("flight.lgb");
+      }
+
+      WHEN("Logging a fatal error, while fatal errors aren't recorded") {
+         Logger::StartFlightRecorder(64 * 1024, Logger::Intent::Verbose | Logger::Intent::Flow);
+         Logger::Instance.FlightRecorderFile = "flight.lgb";
+         Logger::Verbose("context before an unrecorded crash");
+         Logger::Fatal("unrecorded crash");
+
+         Capture decoded;
+         const auto records = Logger::DecodeBinary("flight.lgb", decoded);
+
+         THEN("The flight recorder is still dumped") {
+            REQUIRE(records > 0);
+            REQUIRE(decoded.mText.ends_with("\ncontext before an unrecorded crash"));
+            REQUIRE(capture.mText.ends_with("\nunrecorded crash"));
+         }
+
+         std::remove("flight.lgb");
+      }
+
+      WHEN("Logging a fatal error after the flight recorder is stopped") {
+         Logger::Instance.StopFlightRecorder();
+         Logger::Instance.FlightRecorderFile = "flight.lgb";
+         Logger::Fatal("crash after stopping");
+
+         THEN("The flight recorder isn't dumped") {
+            REQUIRE_FALSE(std::ifstream {"flight.lgb"}.is_open());
+         }
+
+         std::remove("flight.lgb");
+      }
+
+      Logger::Instance.StopFlightRecorder();
+      Logger::Unsilence(Logger::Intent::Verbose);
+      Logger::DettachRedirector(&capture);
+      Logger::Info();
+   }
+}
+
+
+SCENARIO("Logger state is separate for each thread", "[logger]") {
+   GIVEN("A section opened with a warning in the main thread") {
+      auto scope = Logger::WarningTab("Main thread section");
+
+      WHEN("Querying the state from another thread") {
+         size_t tabs = 100;
+         Logger::Intent intent = Logger::Intent::Ignore;
+         std::thread {[&] {
+            tabs = Logger::Instance.GetTabs();
+            intent = Logger::Instance.GetIntent();
+         }}.join();
+
+         THEN("The other thread is unaffected") {
+            REQUIRE(tabs == 0);
+            REQUIRE(intent == Logger::Intent::Info);
+            REQUIRE(Logger::Instance.GetTabs() == 1);
+            REQUIRE(Logger::Instance.GetIntent() == Logger::Intent::Warning);
+         }
+      }
+   }
+}
+
+SCENARIO("Threads format their statements in parallel", "[logger]") {
+   GIVEN("A logger without a worker, redirected to a capture") {
+      Capture capture;
+      Logger::AttachRedirector(&capture);
+      Rendezvous::sArrived = 0;
+
+      WHEN("Two threads log statements, that are formatted at the same time") {
+         std::thread other {[] {
+            Logger::Info("Thread 1 met ", Rendezvous {});
+         }};
+         Logger::Info("Thread 0 met ", Rendezvous {});
+         other.join();
+
+         THEN("Both threads met while formatting, and both lines are whole") {
+            REQUIRE_FALSE(Logger::Instance.IsAsync());
+            REQUIRE(capture.mText.find("\nThread 0 met 2") != std::string::npos);
+            REQUIRE(capture.mText.find("\nThread 1 met 2") != std::string::npos);
+            REQUIRE(capture.mText.size() == 2 * std::string {"\nThread 0 met 2"}.size());
+         }
+      }
+
+      Logger::DettachRedirector(&capture);
+   }
+}
+
+/// Get the parameters of all escape sequences in a text                      
+///   @param text - the escape sequences                                      
+///   @return the numeric parameters, in the order they appear                
+std::vector<int> SgrParameters(std::string_view text) {
+   std::vector<int> parameters;
+   while (text.starts_with("\x1b[")) {
+      const auto end = text.find('m');
+      std::string_view sequence = text.substr(2, end - 2);
+      while (not sequence.empty()) {
+         const auto separator = std::min(sequence.find(';'), sequence.size());
+         parameters.push_back(std::stoi(std::string {sequence.substr(0, separator)}));
+         sequence.remove_prefix(std::min(separator + 1, sequence.size()));
+      }
+      text.remove_prefix(end + 1);
+   }
+   REQUIRE(text.empty());
+   return parameters;
+}
+
+/// Get the parameters of the escape sequences, that fmt makes for a style    
+///   @param style - the style                                                
+///   @return the parameters, with a reset in front                           
+std::vector<int> FmtSgrParameters(const Logger::Style& style) {
+   std::string text;
+   if (style.has_emphasis()) {
+      const auto e = fmt::detail::make_emphasis<char>(style.get_emphasis());
+      text.append(e.begin(), e.end());
+   }
+   if (style.has_foreground()) {
+      const auto f = fmt::detail::make_foreground_color<char>(style.get_foreground());
+      text.append(f.begin(), f.end());
+   }
+   if (style.has_background()) {
+      const auto b = fmt::detail::make_background_color<char>(style.get_background());
+      text.append(b.begin(), b.end());
+   }
+
+   auto parameters = SgrParameters(text);
+   parameters.insert(parameters.begin(), 0);
+   return parameters;
+}
+
+SCENARIO("Precomputed escape sequences", "[logger]") {
+   GIVEN("Every terminal color, emphasis and an RGB color") {
+      std::vector<Logger::Style> styles;
+      for (auto color : {30, 31, 32, 33, 34, 35, 36, 37, 90, 91, 92, 93, 94, 95, 96, 97}) {
+         const auto terminal = static_cast<fmt::terminal_color>(color);
+         styles.push_back(fmt::fg(terminal));
+         styles.push_back(fmt::bg(terminal));
+         styles.push_back(fmt::fg(terminal) | fmt::bg(fmt::terminal_color::black));
+      }
+      // fmt's own emphasis buffer overflows past four bits at once     
+      for (unsigned bits = 1; bits < 256; ++bits)
+         if (std::popcount(bits) <= 4)
+            styles.push_back(fmt::text_style {static_cast<fmt::emphasis>(bits)});
+      styles.push_back(fmt::fg(fmt::rgb(1, 128, 255)) | fmt::bg(fmt::rgb(255, 0, 7)));
+      styles.push_back(fmt::emphasis::bold | fmt::emphasis::underline
+         | fmt::fg(fmt::color::orange) | fmt::bg(fmt::terminal_color::bright_blue));
+      styles.push_back({});
+
+      THEN("They have the same parameters as the ones fmt makes") {
+         for (auto& style : styles)
+            REQUIRE(SgrParameters(Logger::Inner::Escape {style}.View()) == FmtSgrParameters(style));
+      }
+   }
+}
+
+SCENARIO("Deciding when to flush", "[logger]") {
+   using namespace std::chrono;
+   constexpr auto Info = Logger::Intent::Info;
+
+   GIVEN("A flush policy for each mode") {
+      Logger::FlushPolicy policy;
+      policy.bytes = 256;
+      policy.interval = milliseconds {100};
+      policy.errorsImmediate = false;
+
+      WHEN("Flushing immediately") {
+         policy.mode = Logger::FlushPolicy::Immediate;
+
+         THEN("Every fragment is flushed") {
+            REQUIRE(policy.IsDue(0, {}, false, Info));
+            REQUIRE(policy.IsDue(1, {}, false, Info));
+            REQUIRE(policy.IsDue(1, {}, true, Info));
+         }
+      }
+
+      WHEN("Flushing per line") {
+         policy.mode = Logger::FlushPolicy::PerLine;
+
+         THEN("Only the ends of lines are flushed") {
+            REQUIRE(policy.IsDue(1, {}, true, Info));
+            REQUIRE_FALSE(policy.IsDue(1, {}, false, Info));
+            REQUIRE_FALSE(policy.IsDue(1000, seconds {10}, false, Info));
+         }
+      }
+
+      WHEN("Flushing per bytes") {
+         policy.mode = Logger::FlushPolicy::PerBytes;
+
+         THEN("Only enough pending bytes are flushed") {
+            REQUIRE(policy.IsDue(256, {}, false, Info));
+            REQUIRE(policy.IsDue(1000, {}, false, Info));
+            REQUIRE_FALSE(policy.IsDue(255, {}, true, Info));
+            REQUIRE_FALSE(policy.IsDue(255, seconds {10}, false, Info));
+         }
+      }
+
+      WHEN("Flushing per interval") {
+         policy.mode = Logger::FlushPolicy::Interval;
+
+         THEN("Only after enough time has passed, it is flushed") {
+            REQUIRE(policy.IsDue(1, milliseconds {100}, false, Info));
+            REQUIRE(policy.IsDue(1, seconds {1}, false, Info));
+            REQUIRE_FALSE(policy.IsDue(1, milliseconds {99}, true, Info));
+            REQUIRE_FALSE(policy.IsDue(100000, milliseconds {99}, false, Info));
+         }
+      }
+
+      WHEN("Flushing errors immediately, regardless of mode") {
+         policy.mode = Logger::FlushPolicy::PerBytes;
+         policy.errorsImmediate = true;
+
+         THEN("Lines of errors and fatal errors are always flushed, the rest isn't") {
+            using Logger::Intent;
+            REQUIRE_FALSE(policy.IsDue(1, {}, true, Info));
+            REQUIRE(policy.IsDue(1, {}, true, Intent::Error));
+            REQUIRE(policy.IsDue(1, {}, true, Intent::FatalError));
+            REQUIRE_FALSE(policy.IsDue(1, {}, true, Intent::Warning));
+         }
+
+         THEN("Errors aren't flushed fragment by fragment") {
+            using Logger::Intent;
+            REQUIRE_FALSE(policy.IsDue(1, {}, false, Intent::Error));
+            REQUIRE_FALSE(policy.IsDue(1, {}, false, Intent::FatalError));
+         }
+      }
+   }
+}
+
+SCENARIO("Timestamps are cached, but always correct", "[logger]") {
+   using namespace std::chrono;
+
+   GIVEN("A moment in time") {
+      const auto time = system_clock::now();
+      const auto expected = fmt::format("{:%T}",
+         fmt::localtime(system_clock::to_time_t(time)));
+
+      WHEN("Generating a simple timestamp with second precision") {
+         const auto first = Logger::Instance.GetSimpleTimeView(time);
+         const auto second = Logger::Instance.GetSimpleTimeView(time);
+
+         THEN("The time is correct, and the cached text is reused") {
+            REQUIRE(first == expected);
+            REQUIRE(first.data() == second.data());
+         }
+      }
+
+      WHEN("Keeping a simple timestamp, while generating others") {
+         const auto kept = Logger::Instance.GetSimpleTime(time);
+         const auto other = Logger::Instance.GetSimpleTimeView(time + hours {1});
+
+         THEN("The kept text owns its characters") {
+            REQUIRE(kept == expected);
+            REQUIRE(other != expected);
+            REQUIRE(kept.data() != other.data());
+         }
+      }
+
+      WHEN("Generating simple timestamps across many seconds") {
+         for (int s = 0; s < 100000; s += 997) {
+            const auto moment = time + seconds {s};
+            REQUIRE(Logger::Instance.GetSimpleTime(moment) == fmt::format("{:%T}",
+               fmt::localtime(system_clock::to_time_t(moment))));
+         }
+      }
+
+      WHEN("Generating a simple timestamp with millisecond precision") {
+         Logger::Instance.TimeStampPrecision = Logger::Precision::Milliseconds;
+         const auto text = Logger::Instance.GetSimpleTime(floor<seconds>(time) + milliseconds {7});
+         Logger::Instance.TimeStampPrecision = Logger::Precision::Seconds;
+
+         THEN("The fraction is appended") {
+            REQUIRE(text == fmt::format("{:%T}.007",
+               fmt::localtime(system_clock::to_time_t(time))));
+         }
+      }
+
+      WHEN("Generating an advanced timestamp") {
+         const auto text = Logger::Instance.GetAdvancedTime(time);
+
+         THEN("The time is correct") {
+            REQUIRE(text == fmt::format("{:%F %T %Z}",
+               fmt::localtime(system_clock::to_time_t(time))));
+         }
+      }
+   }
+}
+
+/// Read a whole file                                                         
+std::string ReadFile(const char* filename) {
+   std::ifstream file {filename, std::ios::binary};
+   return {std::istreambuf_iterator<char> {file}, {}};
+}
+
+SCENARIO("Logging to a buffered text file", "[logger]") {
+   GIVEN("A text file redirector, with a small buffer") {
+      Logger::FilePolicy policy;
+      policy.buffer = 1;
+      policy.sync = Logger::FilePolicy::NeverSync;
+      auto txt = std::make_unique<Logger::ToTXT>("buffered.txt", policy);
+      Logger::AttachRedirector(txt.get());
+
+      WHEN("Logging lines, some longer than the buffer") {
+         const std::string big(10000, 'x');
+         for (int i = 0; i < 100; ++i)
+            Logger::Info("Line #", i);
+         Logger::Info(big);
+         Logger::Flush();
+
+         THEN("Everything arrives in the file, in order") {
+            const auto text = ReadFile("buffered.txt");
+            REQUIRE(text.starts_with("Log started - "));
+            REQUIRE(text.find("Line #0\n") != std::string::npos);
+            REQUIRE(text.find("Line #99\n") != std::string::npos);
+            REQUIRE(text.find("Line #0\n") < text.find("Line #99\n"));
+            REQUIRE(text.ends_with(big));
+         }
+      }
+
+      WHEN("Logging lines from several threads at once") {
+         constexpr int Threads = 4;
+         constexpr int Lines = 500;
+         std::vector<std::thread> threads;
+         for (int t = 0; t < Threads; ++t) {
+            threads.emplace_back([t] {
+               for (int i = 0; i < Lines; ++i)
+                  Logger::Info("thread ", t, " line ", i, " end");
+            });
+         }
+
+         for (auto& thread : threads)
+            thread.join();
+         Logger::Flush();
+
+         THEN("Every line arrives in one piece, in per-thread order") {
+            std::istringstream stream {ReadFile("buffered.txt")};
+            std::string line;
+            int lines = 0;
+            int next[Threads] {};
+            while (std::getline(stream, line)) {
+               const auto start = line.find("| thread ");
+               if (start == std::string::npos)
+                  continue;
+
+               int t = -1, i = -1;
+               char tail[8] {};
+               REQUIRE(sscanf(line.c_str() + start, "| thread %d line %d %7s", &t, &i, tail) == 3);
+               REQUIRE(std::string {tail} == "end");
+               REQUIRE(i == next[t]++);
+               ++lines;
+            }
+            REQUIRE(lines == Threads * Lines);
+         }
+      }
+
+      WHEN("Clearing the file") {
+         Logger::Info("This should be cleared");
+         Logger::Instance.Clear();
+         Logger::Info("This should remain");
+         Logger::Flush();
+
+         THEN("Only what is logged after clearing remains") {
+            const auto text = ReadFile("buffered.txt");
+            REQUIRE(text.starts_with("Log started - "));
+            REQUIRE(text.find("This should be cleared") == std::string::npos);
+            REQUIRE(text.find("This should remain") != std::string::npos);
+         }
+      }
+
+      Logger::DettachRedirector(txt.get());
+
+      WHEN("Destroying the redirector") {
+         txt.reset();
+
+         THEN("The footer is written") {
+            REQUIRE(ReadFile("buffered.txt").find("Log ended - ") != std::string::npos);
+         }
+      }
+   }
+
+   GIVEN("A text file redirector, that writes its buffer at an interval") {
+      Logger::FilePolicy policy;
+      policy.flush = {.mode = Logger::FlushPolicy::Interval, .interval = std::chrono::milliseconds {50}};
+      policy.sync = Logger::FilePolicy::NeverSync;
+      auto txt = std::make_unique<Logger::ToTXT>("interval.txt", policy);
+      Logger::AttachRedirector(txt.get());
+
+      WHEN("Logging a line, and nothing after it") {
+         Logger::Info("The last line for a while");
+         std::this_thread::sleep_for(std::chrono::milliseconds {500});
+
+         THEN("The line is written once the interval passes, without flushing") {
+            REQUIRE(ReadFile("interval.txt").find("The last line for a while") != std::string::npos);
+         }
+      }
+
+      Logger::DettachRedirector(txt.get());
+   }
+}
+
+SCENARIO("Logging with different flush policies", "[logger]") {
+   for (auto mode : {
+      Logger::FlushPolicy::Immediate, Logger::FlushPolicy::PerLine,
+      Logger::FlushPolicy::PerBytes,  Logger::FlushPolicy::Interval
+   }) {
+      GIVEN("A text file redirector with flush policy #" + std::to_string(int(mode))) {
+         Logger::FilePolicy policy;
+         policy.flush = {.mode = mode, .interval = std::chrono::hours {1}};
+         policy.sync = Logger::FilePolicy::NeverSync;
+         auto txt = std::make_unique<Logger::ToTXT>("policy.txt", policy);
+         Logger::AttachRedirector(txt.get());
+
+         WHEN("Logging infos and an error, that end with a line still open") {
+            Logger::Info("First info");
+            Logger::Error("The error");
+            Logger::Info("Second info");
+            Logger::Info("Open info");
+            const auto before = ReadFile("policy.txt");
+            Logger::Flush();
+            const auto after = ReadFile("policy.txt");
+
+            THEN("The file has what the policy writes, and everything after flushing") {
+               const auto has = [&before](const char* text) {
+                  return before.find(text) != std::string::npos;
+               };
+
+               // A line ends when the next one starts, and errors are  
+               // written as soon as they end, in any mode              
+               REQUIRE(has("First info"));
+               REQUIRE(has("The error"));
+               REQUIRE(has("Second info") == (mode <= Logger::FlushPolicy::PerLine));
+               REQUIRE(has("Open info") == (mode == Logger::FlushPolicy::Immediate));
+               REQUIRE(after.find("Open info") != std::string::npos);
+               REQUIRE(after.starts_with(before));
+            }
+         }
+
+         Logger::DettachRedirector(txt.get());
+      }
+   }
+}
+
+SCENARIO("Rotating log files", "[logger]") {
+   GIVEN("Text and HTML redirectors, that rotate small files") {
+      Logger::FilePolicy policy;
+      policy.sync = Logger::FilePolicy::NeverSync;
+      policy.rotateSize = 512;
+      policy.rotateKeep = 2;
+      auto txt = std::make_unique<Logger::ToTXT>("rotated.txt", policy);
+      auto html = std::make_unique<Logger::ToHTML>("rotated.htm", policy);
+      Logger::AttachRedirector(txt.get());
+      Logger::AttachRedirector(html.get());
+
+      WHEN("Logging more than the size of a few files") {
+         for (int i = 0; i < 200; ++i)
+            Logger::Info("Rotated line #", i);
+         Logger::DettachRedirector(txt.get());
+         Logger::DettachRedirector(html.get());
+         txt.reset();
+         html.reset();
+
+         THEN("Only the newest files remain, each one complete") {
+            for (auto name : {"rotated.txt", "rotated.1.txt", "rotated.2.txt"}) {
+               const auto text = ReadFile(name);
+               REQUIRE(text.starts_with("Log started - "));
+               REQUIRE(text.find("Log ended - ") != std::string::npos);
+            }
+            for (auto name : {"rotated.htm", "rotated.1.htm", "rotated.2.htm"}) {
+               const auto text = ReadFile(name);
+               REQUIRE(text.starts_with("<!DOCTYPE html><html>"));
+               REQUIRE(text.ends_with("</html>"));
+            }
+
+            REQUIRE(ReadFile("rotated.txt").find("Rotated line #199\n") != std::string::npos);
+            REQUIRE(ReadFile("rotated.2.txt").find("Rotated line #0\n") == std::string::npos);
+            REQUIRE_FALSE(std::ifstream {"rotated.3.txt"}.is_open());
+            REQUIRE_FALSE(std::ifstream {"rotated.txt.next"}.is_open());
+         }
+      }
+
+      Logger::DettachRedirector(txt.get());
+      Logger::DettachRedirector(html.get());
+   }
+}
+
+SCENARIO("Logging to a memory-mapped text file", "[logger]") {
+   GIVEN("A memory-mapped text file redirector, that grows in small steps") {
+      Logger::FilePolicy policy;
+      policy.preallocate = 1;
+      policy.sync = Logger::FilePolicy::NeverSync;
+      auto txt = std::make_unique<Logger::ToMappedTXT>("mapped.txt", policy);
+      Logger::AttachRedirector(txt.get());
+
+      WHEN("Logging more than a single step") {
+         const std::string big(100000, 'x');
+         for (int i = 0; i < 1000; ++i)
+            Logger::Info("Mapped line #", i);
+         Logger::Info(big);
+         Logger::Flush();
+
+         THEN("Everything is readable from the file, before it is closed") {
+            const auto text = ReadFile("mapped.txt");
+            REQUIRE(text.starts_with("Log started - "));
+            REQUIRE(text.find("Mapped line #0\n") != std::string::npos);
+            REQUIRE(text.find("Mapped line #999\n") != std::string::npos);
+            REQUIRE(text.find(big) != std::string::npos);
+         }
+
+         Logger::DettachRedirector(txt.get());
+         txt.reset();
+
+         THEN("Closing the file trims it, and writes the footer") {
+            const auto text = ReadFile("mapped.txt");
+            REQUIRE(text.find('\0') == std::string::npos);
+            REQUIRE(text.find("Log ended - ") != std::string::npos);
+         }
+      }
+
+      WHEN("Clearing the file") {
+         Logger::Info("This should be cleared");
+         Logger::Instance.Clear();
+         Logger::Info("This should remain");
+         Logger::DettachRedirector(txt.get());
+         txt.reset();
+
+         THEN("Only what is logged after clearing remains") {
+            const auto text = ReadFile("mapped.txt");
+            REQUIRE(text.starts_with("Log started - "));
+            REQUIRE(text.find("This should be cleared") == std::string::npos);
+            REQUIRE(text.find("This should remain") != std::string::npos);
+         }
+      }
+
+      if (txt)
+         Logger::DettachRedirector(txt.get());
+   }
+}
+
+/// Get the part of a text log between the header and the footer              
+std::string StripHeaderAndFooter(const std::string& text) {
+   const auto begin = text.find("\n\n") + 2;
+   const auto end = text.rfind("\n\nLog ended - ");
+   return text.substr(begin, end - begin);
+}
+
+SCENARIO("Logging to a binary file", "[logger]") {
+   GIVEN("A binary and a text file redirector") {
+      auto binary = std::make_unique<Logger::ToBinary>("binary.lgb");
+      auto txt = std::make_unique<Logger::ToTXT>("binary.txt");
+      auto html = std::make_unique<Logger::ToHTML>("binary.htm");
+      Logger::AttachRedirector(binary.get());
+      Logger::AttachRedirector(txt.get());
+      Logger::AttachRedirector(html.get());
+
+      for (int i = 0; i < 100; ++i) {
+         Logger::Info(Logger::Color::Red, "Binary line #", i, Logger::Color::Blue, " in blue");
+         const auto tab = Logger::Section("Section #", i);
+         Logger::Warning("Inside the section");
+      }
+
+      Logger::DettachRedirector(binary.get());
+      Logger::DettachRedirector(txt.get());
+      Logger::DettachRedirector(html.get());
+      binary.reset();
+      txt.reset();
+      html.reset();
+
+      WHEN("Decoding the binary file as text") {
+         const auto records = Logger::DecodeBinary("binary.lgb", Logger::ToTXT {"decoded.txt"});
+
+         THEN("The result is the same as the text file, except for times in header and footer") {
+            REQUIRE(records > 400);
+            const auto expected = ReadFile("binary.txt");
+            const auto decoded = ReadFile("decoded.txt");
+            REQUIRE(decoded.starts_with("Log started - "));
+            REQUIRE(StripHeaderAndFooter(decoded) == StripHeaderAndFooter(expected));
+            REQUIRE(ReadFile("binary.lgb").size() < ReadFile("binary.htm").size() / 2);
+         }
+      }
+
+      WHEN("Decoding a damaged binary file") {
+         auto damaged = ReadFile("binary.lgb");
+         damaged[damaged.size() / 2] ^= 0x55;
+         std::ofstream {"damaged.lgb", std::ios::binary} << damaged;
+
+         const auto all = Logger::DecodeBinary("binary.lgb", Capture {});
+         const auto some = Logger::DecodeBinary("damaged.lgb", Capture {});
+
+         THEN("Decoding stops at the damaged record") {
+            REQUIRE(some > 0);
+            REQUIRE(some < all);
+            REQUIRE(Logger::DecodeBinary("binary.txt", Capture {}) == 0);
+         }
+      }
+
+      WHEN("Decoding a line with an intent out of range, and a valid checksum") {
+         // CRC-32, the same as the one the binary log uses             
+         const auto crc = [](const std::string& data) {
+            uint32_t crc = ~0u;
+            for (unsigned char byte : data) {
+               crc ^= byte;
+               for (int bit = 0; bit < 8; ++bit)
+                  crc = (crc >> 1) ^ (crc & 1 ? 0xEDB88320u : 0u);
+            }
+            return ~crc;
+         };
+
+         std::string crafted {"LGLOGB\n\x01", 8};
+         const auto append = [&](const std::string& record) {
+            const auto checksum = crc(record);
+            crafted += record;
+            crafted.append(reinterpret_cast<const char*>(&checksum), sizeof(checksum));
+         };
+
+         // Default style with id 0, a line of intent Counter, and text 
+         append(std::string {"\x02\x00\x0C", 3} + std::string(12, '\0'));
+         append(std::string {"\x01\x00", 2} + char(Logger::Intent::Counter) + std::string {"\x00\x00", 2});
+         append(std::string {"\x00\x00\x05", 3} + "hello");
+         std::ofstream {"crafted.lgb", std::ios::binary} << crafted;
+
+         THEN("The line is decoded without an intent") {
+            REQUIRE(Logger::DecodeBinary("crafted.lgb", Logger::ToTXT {"crafted.txt"}) == 3);
+            REQUIRE(ReadFile("crafted.txt").find("| | hello") != std::string::npos);
+         }
+      }
+   }
+}
+
 SCENARIO("Logging to an html log file", "[logger]") {
    GIVEN("An initialized logger with an HTML attachment") {
-      WHEN("TODO") {
-         THEN("TODO") {
-            REQUIRE(true);
+      auto html = std::make_unique<Logger::ToHTML>("styled.htm");
+      Logger::AttachRedirector(html.get());
+
+      WHEN("Logging with repeated and changing styles") {
+         Logger::Line(Logger::Color::Red, "red ", Logger::Color::Red, "still red ",
+            Logger::Color::Blue, "blue");
+         Logger::Line(Logger::Emphasis::Bold, "bold");
+         Logger::DettachRedirector(html.get());
+         html.reset();
+
+         THEN("Styles are classes from a stylesheet, and spans are balanced") {
+            const auto text = ReadFile("styled.htm");
+            REQUIRE(text.find("<style>") < text.find("<body>"));
+            REQUIRE(text.find("style = ") == std::string::npos);
+            REQUIRE(text.find("red <span") == std::string::npos);
+            REQUIRE(text.find("red still red </span><span class=") != std::string::npos);
+            REQUIRE(text.find("<span class=\"fc eb\">bold") != std::string::npos);
+            REQUIRE(text.find("\"></span>") == std::string::npos);
+            REQUIRE(text.ends_with("</html>"));
+
+            size_t opened = 0, closed = 0;
+            for (auto at = text.find("<span"); at != std::string::npos; at = text.find("<span", at + 1))
+               ++opened;
+            for (auto at = text.find("</span>"); at != std::string::npos; at = text.find("</span>", at + 1))
+               ++closed;
+            REQUIRE(opened == closed);
+         }
+      }
+
+      WHEN("Logging with each emphasis") {
+         Logger::Line(Logger::Emphasis::Blink, "blink ", Logger::Emphasis::Reverse, "reverse");
+         Logger::DettachRedirector(html.get());
+         html.reset();
+
+         THEN("Each emphasis class has a rule in the stylesheet") {
+            const auto text = ReadFile("styled.htm");
+            const auto sheet = text.substr(0, text.find("</style>"));
+            for (auto name : {".eb{", ".ef{", ".ei{", ".eu{", ".ek{", ".er{", ".ec{", ".es{"})
+               REQUIRE(sheet.find(name) != std::string::npos);
+            REQUIRE(sheet.find("@keyframes blink") != std::string::npos);
+            REQUIRE(text.find("ek\">blink") != std::string::npos);
          }
       }
+
+      if (html)
+         Logger::DettachRedirector(html.get());
    }
 }
 
-SCENARIO("Logging to a benchmark file", "[logger]") {
-   GIVEN("An initialized logger") {
-      WHEN("TODO") {
-         THEN("TODO") {
-            REQUIRE(true);
+#ifndef _WIN32
+/// Redirector, that writes straight to a file descriptor                     
+struct WriteToFile final : Logger::A::Interface {
+   int mFile;
+
+   WriteToFile(int file) : mFile {file} {}
+
+   void Write(const Logger::TextView& text) const noexcept {
+      [[maybe_unused]] const auto written = ::write(mFile, text.data(), text.size());
+   }
+   void Write(Logger::Style) const noexcept {}
+   void NewLine() const noexcept { Write("\n"); }
+   void Clear() const noexcept {}
+};
+
+SCENARIO("Suppressing repeated lines until the process exits", "[logger]") {
+   GIVEN("A child process, that repeats a line and exits") {
+      const auto child = ::fork();
+      if (child == 0) {
+         // Never destroyed, so it outlives the logger                  
+         const int file = ::open("repeated.txt", O_WRONLY | O_CREAT | O_TRUNC, 0644);
+         Logger::AttachRedirector(new WriteToFile {file});
+         Logger::Instance.SuppressRepeats = true;
+         for (int i = 0; i < 10; ++i)
+            Logger::Info("Last words, repeated");
+         std::exit(0);
+      }
+
+      int status = 0;
+      ::waitpid(child, &status, 0);
+
+      THEN("The repeats are written when the main thread ends") {
+         REQUIRE(WIFEXITED(status));
+         REQUIRE(ReadFile("repeated.txt").find("repeated 9 more times") != std::string::npos);
+      }
+
+      std::remove("repeated.txt");
+   }
+}
+
+/// Redirect stdout to a file, for as long as this is alive                   
+struct CaptureStdout {
+   std::string mFilename;
+   int mSaved;
+
+   CaptureStdout(std::string filename) : mFilename {std::move(filename)} {
+      std::fflush(stdout);
+      mSaved = ::dup(STDOUT_FILENO);
+      const int file = ::open(mFilename.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+      ::dup2(file, STDOUT_FILENO);
+      ::close(file);
+   }
+
+   ~CaptureStdout() {
+      std::fflush(stdout);
+      ::dup2(mSaved, STDOUT_FILENO);
+      ::close(mSaved);
+      std::remove(mFilename.c_str());
+   }
+};
+
+SCENARIO("Flushing console output of other threads", "[logger]") {
+   const auto backup = Logger::Instance.ConsoleFlush;
+
+   GIVEN("A console, that is written only when enough bytes are assembled") {
+      Logger::Instance.ConsoleFlush.mode = Logger::FlushPolicy::PerBytes;
+
+      WHEN("Another thread logs a line and keeps running, and this one flushes") {
+         std::string before, after;
+         {
+            const CaptureStdout capture {"console.txt"};
+            std::atomic<bool> logged {}, done {};
+            std::thread other([&] {
+               Logger::Info("Line from another thread");
+               logged = true;
+               while (not done)
+                  std::this_thread::yield();
+            });
+
+            while (not logged)
+               std::this_thread::yield();
+            before = ReadFile("console.txt");
+            Logger::Flush();
+            after = ReadFile("console.txt");
+
+            done = true;
+            other.join();
+         }
+
+         THEN("The other thread's line is written by the flush") {
+            REQUIRE(before.find("Line from another thread") == std::string::npos);
+            REQUIRE(after.find("Line from another thread") != std::string::npos);
          }
       }
    }
-}
\ No newline at end of file
+
+   Logger::Instance.ConsoleFlush = backup;
+}
+
+/// Log to an html file in a child process, that crashes with a signal        
+///   @param signal - the signal to crash with                                
+///   @param previous - the handler for the signal, before the crash handler  
+///   @return the status of the child process                                 
+int CrashWhileLogging(int signal, void(*previous)(int)) {
+   const auto child = ::fork();
+   if (child == 0) {
+      ::signal(signal, previous);
+      Logger::ToHTML html {"crashed.htm"};
+      Logger::AttachRedirector(&html);
+      Logger::InstallCrashHandler();
+      Logger::Info("Last words before the crash");
+      ::raise(signal);
+      ::_exit(0);
+   }
+
+   int status = 0;
+   ::waitpid(child, &status, 0);
+   return status;
+}
+
+SCENARIO("Salvaging buffered logs on a crash", "[logger]") {
+   GIVEN("A child process, that logs to an html file with a crash handler") {
+      WHEN("The child aborts") {
+         const auto status = CrashWhileLogging(SIGABRT, SIG_DFL);
+
+         THEN("The buffered lines are written, and the html is terminated") {
+            REQUIRE(WIFSIGNALED(status));
+            REQUIRE(WTERMSIG(status) == SIGABRT);
+            const auto text = ReadFile("crashed.htm");
+            REQUIRE(text.find("Last words before the crash") != std::string::npos);
+            REQUIRE(text.ends_with("</html>"));
+         }
+      }
+
+      WHEN("The child is terminated, and already had a handler") {
+         const auto status = CrashWhileLogging(SIGTERM, [](int) { ::_exit(42); });
+
+         THEN("The previous handler runs after salvaging") {
+            REQUIRE(WIFEXITED(status));
+            REQUIRE(WEXITSTATUS(status) == 42);
+            REQUIRE(ReadFile("crashed.htm").ends_with("</html>"));
+         }
+      }
+
+      WHEN("A child installs the crash handler") {
+         const auto child = ::fork();
+         if (child == 0) {
+            Logger::InstallCrashHandler();
+            ::stack_t stack {};
+            ::sigaltstack(nullptr, &stack);
+            ::_exit(stack.ss_flags & SS_DISABLE ? 1 : 0);
+         }
+
+         int status = 0;
+         ::waitpid(child, &status, 0);
+
+         THEN("It has an alternate stack for handling stack overflows") {
+            REQUIRE(WIFEXITED(status));
+            REQUIRE(WEXITSTATUS(status) == 0);
+         }
+      }
+
+      std::remove("crashed.htm");
+   }
+}
+#endif
\ No newline at end of file
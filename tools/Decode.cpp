@@ -0,0 +1,51 @@
+///                                                                           
+/// Langulus::Logger                                                          
+/// Copyright (c) 2012 Dimo Markov <team@langulus.com>                        
+/// Part of the Langulus framework, see https://langulus.com                  
+///                                                                           
+/// SPDX-License-Identifier: MIT                                              
+///                                                                           
+/// Decodes a log, written by Logger::ToBinary, into a text or HTML file,     
+/// depending on the extension of the output file:                            
+///    LangulusLoggerDecode input.lgb output.txt                              
+///    LangulusLoggerDecode input.lgb output.htm                              
+///                                                                           
+#include <Logger/Logger.hpp>
+#include <cstdio>
+#include <string_view>
+
+using namespace Langulus;
+
+
+int main(int argc, char* argv[]) {
+   if (argc != 3) {
+      std::fprintf(stderr, "Usage: %s <input.lgb> <output.txt|output.htm>\n", argv[0]);
+      return 1;
+   }
+
+   const std::string_view output {argv[2]};
+   const bool html = output.ends_with(".htm") or output.ends_with(".html");
+
+   const auto decode = [&](const Logger::A::Interface& sink) {
+      return Logger::DecodeBinary(argv[1], sink);
+   };
+
+   size_t records = 0;
+   try {
+      records = html
+         ? decode(Logger::ToHTML {output})
+         : decode(Logger::ToTXT {output});
+   }
+   catch (...) {
+      std::fprintf(stderr, "Can't create %s\n", argv[2]);
+      return 1;
+   }
+
+   if (records == 0) {
+      std::fprintf(stderr, "Nothing was decoded from %s\n", argv[1]);
+      return 1;
+   }
+
+   std::fprintf(stderr, "Decoded %zu records\n", records);
+   return 0;
+}